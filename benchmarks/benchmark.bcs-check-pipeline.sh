@@ -0,0 +1,395 @@
+#!/usr/bin/bash
+# shellcheck disable=SC2034
+# benchmark-bcs-check-pipeline.sh - Processes spawned by one bcs check (mock backend)
+set -euo pipefail
+shopt -s inherit_errexit shift_verbose extglob nullglob
+
+##
+## INITIALIZATION
+##
+
+# Script metadata
+declare -r VERSION=1.0.0 # 2026-10-16 - Initial version
+declare -r SCRIPT_NAME=${0##*/}
+#shellcheck disable=SC2155
+declare -r SCRIPT_DIR=$(cd -P -- "${0%/*}" && pwd -P)
+
+# Test name derived from script filename: 'benchmark.X.sh' → 'X'
+declare -- TESTNAME=${SCRIPT_NAME#benchmark.}
+TESTNAME=${TESTNAME%.sh}
+declare -r TESTNAME
+
+# Configuration
+declare -i RUNS_PER_TEST=10
+declare -- BCS_UNDER_TEST="$SCRIPT_DIR"/../bcs BCS_BASELINE=''
+declare -- CHECKED_SCRIPT="$SCRIPT_DIR"/../tests/fixtures/07-piped-while-loop.sh
+
+# Output files
+#shellcheck disable=SC2155
+declare -r RESULTS_FILE=${TESTNAME}_results_$(printf '%(%F_%T)T').txt
+
+# Kernel's most recently allocated PID: its advance over a run counts forks
+declare -r LAST_PID=/proc/sys/kernel/ns_last_pid
+
+# Builds measured: the bcs under test, and with -b a baseline to compare
+declare -a VARIANTS=(current)
+declare -Ar VARIANT_LABELS=([baseline]='baseline' [current]='current')
+
+# Test results storage
+declare -a times_baseline times_current
+declare -A forks=() jq_runs=()
+
+# Scratch installs, mock responses and the counting jq shim
+declare -- TMPDIR_BENCH=''
+
+##
+## FUNCTIONS
+##
+
+error() { >&2 printf '%s: ✗ %s\n' "$SCRIPT_NAME" "$*"; }
+die() { (($# < 2)) || error "${@:2}"; exit "${1:-0}"; }
+noarg() {
+  if (($# <= 1)) || [[ ${2:0:1} == '-' ]]; then
+    die 22 "Option ${1@Q} requires an argument"
+  fi
+}
+
+show_help() {
+  cat <<HELP
+$SCRIPT_NAME $VERSION - Processes spawned by one bcs check (mock backend)
+
+Measures the wall time, process forks and jq(1) runs of a complete
+'bcs check' against the offline mock backend (-m mock:DIR), so the
+whole pipeline -- prompt assembly, response parsing, JSON envelope,
+severity exit -- runs without a network or a model:
+
+  text      bcs check -m mock:DIR FILE
+  json      bcs check -j -m mock:DIR FILE
+  hybrid    bcs check -j --engine hybrid -m mock:DIR FILE
+            (static findings merged into the model's)
+
+Every call runs with --no-cache and --no-shellcheck, so each one does
+the full work and no external analyser skews the counts.
+
+Forks are counted from the advance of $LAST_PID over a
+run, minus the bcs process itself -- exact on an idle host, an upper
+bound on a busy one. jq runs are counted in one extra pass per series
+through a jq wrapper in \$HOME/.local/bin, first on bcs's hardened
+PATH (not timed). Every run uses a scratch HOME, so no user bcs.conf
+or policy.conf applies.
+
+Default run: 3 test series at 20 calls each.
+With -i NUM: the same series at NUM calls each.
+Each test series repeats RUNS_PER_TEST times and reports mean/median/stddev.
+
+Usage: $SCRIPT_NAME [OPTIONS]
+
+Options:
+  -h, --help       Show this help and exit
+  -V, --version    Show version and exit
+  -i NUM           Calls per run (default: 20)
+  -r NUM           Runs per test series (default: 10)
+  -b FILE          Baseline bcs script measured alongside ../bcs, e.g. an
+                   older release (git show REV:bcs > FILE)
+  -f FILE          Script to check (default: tests/fixtures/07-piped-while-loop.sh)
+
+Output:
+  stdout           Live progress, per-series results, forks and jq runs per call
+  file             ${TESTNAME}_results_YYYY-MM-DD_HH:MM:SS.txt
+                   (system info, raw numbers, analysis)
+
+Exit codes:
+  0  success
+  2  unexpected positional argument
+  3  bcs script, its data/ directory or the checked script not found
+ 22  unknown option or missing option argument
+
+HELP
+}
+
+print_system_info() {
+  cat <<SYSINFO
+System Information
+==================
+Date: $(date -Iseconds)
+Hostname: $(hostname)
+Bash Version: $BASH_VERSION
+jq: $(jq --version)
+CPU: $(grep -m1 'model name' /proc/cpuinfo | cut -d: -f2 | xargs)
+Kernel: $(uname -r)
+bcs: $BCS_UNDER_TEST
+baseline: ${BCS_BASELINE:-(none)}
+Checked script: $CHECKED_SCRIPT ($(wc -l < "$CHECKED_SCRIPT") lines)
+Runs per test: $RUNS_PER_TEST
+
+SYSINFO
+}
+
+cleanup() {
+  [[ -z $TMPDIR_BENCH ]] || rm -rf -- "$TMPDIR_BENCH"
+}
+
+setup_installs() {
+  # One scratch install per build (bcs finds data/ beside itself), with a
+  # fresh rule index so both load the rules the same way
+  TMPDIR_BENCH=$(mktemp -d -t bench-check-pipeline-XXXXX)
+  local -- variant src
+  for variant in "${VARIANTS[@]}"; do
+    src=$BCS_UNDER_TEST
+    [[ $variant == current ]] || src=$BCS_BASELINE
+    mkdir -p "$TMPDIR_BENCH/$variant"/data "$TMPDIR_BENCH/$variant"/cache \
+             "$TMPDIR_BENCH/$variant"/state
+    install -m 755 -- "$src" "$TMPDIR_BENCH/$variant"/bcs
+    cp -- "$BCS_DIR"/data/[0-9]*.md "$TMPDIR_BENCH/$variant"/data/
+    "$TMPDIR_BENCH/$variant"/bcs generate -q
+  done
+
+  # Recorded answers: one finding of each level, so the severity exit and
+  # the envelope have real work to do
+  mkdir -p "$TMPDIR_BENCH"/mock
+  printf '%s\n' '[ERROR] BCS0101 line 1: Missing strict mode' \
+    '[WARN] BCS0503 line 5: Pipe into while loop runs in a subshell' \
+    '___TOKENS___ in=9000 out=120' > "$TMPDIR_BENCH"/mock/default.txt
+  printf '%s\n' '[{"line":1,"endLine":1,"level":"error","code":101,"bcsCode":"BCS0101","tier":"core","message":"Missing strict mode","fixSuggestion":"set -euo pipefail"},{"line":5,"endLine":5,"level":"warning","code":503,"bcsCode":"BCS0503","tier":"recommended","message":"Pipe into while loop","fixSuggestion":"< <(...)"}]' \
+    '___TOKENS___ in=9000 out=160' > "$TMPDIR_BENCH"/mock/default.json
+
+  # Scratch homes; the counting one has a jq wrapper that logs one line
+  # per run, then execs the real jq
+  mkdir -p "$TMPDIR_BENCH"/home "$TMPDIR_BENCH"/count-home/.local/bin
+  printf '#!/bin/bash\necho >> "$JQ_COUNT_FILE"\nexec %q "$@"\n' "$(command -v jq)" \
+    > "$TMPDIR_BENCH"/count-home/.local/bin/jq
+  chmod 755 "$TMPDIR_BENCH"/count-home/.local/bin/jq
+}
+
+run_benchmark() {
+  # Benchmark: $iterations checks by bcs ($variant install) with $args
+  # Prints "elapsed_us forks_per_call"
+  local -r variant=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i i start end pid_before=0 pid_after=0
+  local -r bcs="$TMPDIR_BENCH/$variant"/bcs
+  local -x HOME="$TMPDIR_BENCH"/home
+  local -x XDG_CACHE_HOME="$TMPDIR_BENCH/$variant"/cache XDG_STATE_HOME="$TMPDIR_BENCH/$variant"/state
+
+  [[ ! -r $LAST_PID ]] || read -r pid_before < "$LAST_PID"
+  start=${EPOCHREALTIME/./}
+
+  i=-$iterations
+  #bcscheck disable=BCS0505
+  while ((1)); do
+    ((i++)) || break
+    "$bcs" "${args[@]}" &>/dev/null ||:
+  done
+
+  end=${EPOCHREALTIME/./}
+  [[ ! -r $LAST_PID ]] || read -r pid_after < "$LAST_PID"
+
+  echo "$((end - start)) $(( (pid_after - pid_before) / iterations - 1 ))"
+}
+
+count_jq_runs() {
+  # jq processes started by one check of bcs ($variant install) with $args
+  local -r variant=$1
+  local -a args=("${@:2}")
+  local -x XDG_CACHE_HOME="$TMPDIR_BENCH/$variant"/cache XDG_STATE_HOME="$TMPDIR_BENCH/$variant"/state
+  local -x HOME="$TMPDIR_BENCH"/count-home JQ_COUNT_FILE="$TMPDIR_BENCH"/jq.count
+  : > "$JQ_COUNT_FILE"
+  "$TMPDIR_BENCH/$variant"/bcs "${args[@]}" &>/dev/null ||:
+  wc -l < "$JQ_COUNT_FILE"
+}
+
+calculate_statistics() {
+  # Calculate mean, median, stddev from array of values (microseconds)
+  local -n values=$1
+  local -i sum=0 count=${#values[@]} val=0
+  local -a sorted
+  local -i mean median variance sum_sq_diff stddev
+
+  for val in "${values[@]}"; do
+    sum+=val
+  done
+  mean=$((sum / count))
+
+  mapfile -t sorted < <(printf '%s\n' "${values[@]}" | sort -n)
+  if ((count % 2 == 0)); then
+    median=$(( (sorted[count/2-1] + sorted[count/2]) / 2 ))
+  else
+    median=${sorted[count/2]}
+  fi
+
+  sum_sq_diff=0
+  for val in "${values[@]}"; do
+    ((sum_sq_diff += (val - mean) * (val - mean)))
+  done
+  variance=$((sum_sq_diff / count))
+  stddev=$(awk "BEGIN {printf \"%.0f\", sqrt($variance)}")
+
+  # Return: mean median stddev (in microseconds)
+  echo "$mean $median $stddev"
+}
+
+format_time() {
+  # Convert microseconds to milliseconds per call
+  local -i us=$1 calls=$2
+  awk "BEGIN {printf \"%.1fms\", $us/$calls/1000}"
+}
+
+run_test_series() {
+  local -r test_name=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i run
+  local -- result variant
+
+  echo "Running test: $test_name (calls: $iterations, runs: $RUNS_PER_TEST)"
+  echo '========================================================================'
+
+  times_baseline=()
+  times_current=()
+  for variant in "${VARIANTS[@]}"; do
+    jq_runs[$variant]=$(count_jq_runs "$variant" "${args[@]}")
+  done
+  for ((run=1; run<=RUNS_PER_TEST; run+=1)); do
+    for variant in "${VARIANTS[@]}"; do
+      local -n times=times_$variant
+      printf '\rRun %2d/%d: Testing %-10s' "$run" "$RUNS_PER_TEST" "${VARIANT_LABELS[$variant]}..."
+      result=$(run_benchmark "$variant" "$iterations" "${args[@]}")
+      times+=("${result% *}")
+      forks[$variant]=${result#* }
+      unset -n times
+    done
+  done
+  printf '\rRun %2d/%d: Complete!             \n' "$RUNS_PER_TEST" "$RUNS_PER_TEST"
+
+  # Display results (per call)
+  local -A mean=()
+  local -a stats
+  echo
+  echo "Results for: $test_name"
+  echo '-------------------------------------------'
+  printf '%-10s %12s %12s %12s %8s %8s\n' Build Mean Median StdDev Forks 'jq runs'
+  echo "Test: $test_name (calls per run: $iterations)" >> "$RESULTS_FILE"
+  for variant in "${VARIANTS[@]}"; do
+    IFS=' ' read -ra stats <<<"$(calculate_statistics "times_$variant")"
+    mean[$variant]=${stats[0]}
+    printf '%-10s %12s %12s %12s %8s %8s\n' "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}" "${jq_runs[$variant]}"
+    printf '%-8s - Mean: %s, Median: %s, StdDev: %s, Forks/call: %s, jq runs/call: %s\n' \
+      "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}" "${jq_runs[$variant]}" \
+      >> "$RESULTS_FILE"
+  done
+
+  if [[ -n ${mean[baseline]:-} ]]; then
+    # Guard against degenerate 0 µs measurements
+    local -i fastest=${mean[current]}
+    ((fastest)) || fastest=1
+    local -- ratio
+    ratio=$(awk "BEGIN {printf \"%.2f\", ${mean[baseline]}/$fastest}")
+    printf '\n◉ current is %sx the speed of baseline, %d fewer forks per check\n' \
+      "$ratio" $((forks[baseline] - forks[current]))
+    { echo "Speedup (baseline -> current): ${ratio}x"
+      echo
+    } >> "$RESULTS_FILE"
+  else
+    echo >> "$RESULTS_FILE"
+  fi
+
+  echo
+  echo '========================================================================'
+  echo
+}
+
+##
+## EXECUTION
+##
+
+main() {
+  local -i iterations=20
+
+  # Argument parsing
+  while (($#)); do
+    case $1 in
+      -h|--help)    show_help; exit 0 ;;
+      -V|--version) printf '%s %s\n' "$SCRIPT_NAME" "$VERSION"; exit 0 ;;
+      -i)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -i requires a positive integer, got ${1@Q}"
+                    iterations=$1 ;;
+      -r)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -r requires a positive integer, got ${1@Q}"
+                    RUNS_PER_TEST=$1 ;;
+      -b)           noarg "$@"; shift; BCS_BASELINE=$1 ;;
+      -f)           noarg "$@"; shift; CHECKED_SCRIPT=$1 ;;
+      --)           shift; break ;;
+      -[hVirbf]?*)  set -- "${1:0:2}" "-${1:2}" "${@:2}"; continue ;;
+      -*)           die 22 "Unknown option ${1@Q}" ;;
+      *)            die 2 "Unexpected argument ${1@Q}" ;;
+    esac
+    shift
+  done
+  readonly RUNS_PER_TEST
+
+  [[ -f $BCS_UNDER_TEST ]] || die 3 "bcs not found at ${BCS_UNDER_TEST@Q}"
+  if [[ -n $BCS_BASELINE ]]; then
+    [[ -f $BCS_BASELINE ]] || die 3 "Baseline bcs not found at ${BCS_BASELINE@Q}"
+    VARIANTS=(baseline current)
+  fi
+  readonly VARIANTS
+  [[ -f $CHECKED_SCRIPT ]] || die 3 "Script to check not found at ${CHECKED_SCRIPT@Q}"
+  CHECKED_SCRIPT=$(realpath -- "$CHECKED_SCRIPT")
+  # Section files come from the checkout this benchmark lives in
+  declare -gr BCS_DIR="$SCRIPT_DIR"/..
+  [[ -d $BCS_DIR/data ]] || die 3 "No data directory in ${BCS_DIR@Q}"
+
+  trap cleanup EXIT
+  setup_installs
+
+  { print_system_info
+    echo "Starting benchmarks: 3 test series at ${iterations} calls (${RUNS_PER_TEST} runs each)"
+    echo
+  } | tee "$RESULTS_FILE"
+
+  local -a common=(--no-cache --no-shellcheck -m mock:"$TMPDIR_BENCH"/mock)
+  run_test_series "text (${iterations})" "$iterations" check "${common[@]}" "$CHECKED_SCRIPT"
+  run_test_series "json (${iterations})" "$iterations" check -j "${common[@]}" "$CHECKED_SCRIPT"
+  run_test_series "hybrid json (${iterations})" "$iterations" \
+    check -j --engine hybrid "${common[@]}" "$CHECKED_SCRIPT"
+
+  { cat <<SUMMARY
+Benchmark Complete
+==================
+
+Detailed results saved to: $RESULTS_FILE
+
+Analysis:
+---------
+A check used to start jq for each step of the response: the thinking
+block, the payload, the error message, the text, the token line, three
+or more type probes in the findings validation, the envelope, one more
+per meta merge (stream, http, chunks, scope) and the final error-level
+probe. Now each phase is one jq program: the payload, the response
+(error, tokens and text as NUL-separated fields read by readarray), and
+the envelope (validation, static merge, every meta field); the severity
+probe is a Bash pattern match over the pretty-printed document.
+
+The mock backend parses no vendor body, so these series show the render
+phase; the vendor backends drop their extra payload and response jq runs
+on top. Times are per call and include bcs start-up.
+
+SUMMARY
+  } | tee -a "$RESULTS_FILE"
+
+  echo
+  echo "Results saved to ${RESULTS_FILE@Q}"
+}
+
+main "$@"
+
+#fin
@@ -0,0 +1,350 @@
+#!/usr/bin/bash
+# shellcheck disable=SC2034
+# benchmark-rule-index.sh - Rule loading: section scan vs. rule index vs. tier snapshot
+set -euo pipefail
+shopt -s inherit_errexit shift_verbose extglob nullglob
+
+##
+## INITIALIZATION
+##
+
+# Script metadata
+declare -r VERSION=1.1.0 # 2026-10-16 - Tier snapshot variant, bcs check start-up
+declare -r SCRIPT_NAME=${0##*/}
+#shellcheck disable=SC2155
+declare -r SCRIPT_DIR=$(cd -P -- "${0%/*}" && pwd -P)
+
+# Test name derived from script filename: 'benchmark.X.sh' → 'X'
+declare -- TESTNAME=${SCRIPT_NAME#benchmark.}
+TESTNAME=${TESTNAME%.sh}
+declare -r TESTNAME
+
+# Configuration
+declare -i RUNS_PER_TEST=10
+declare -- BCS_UNDER_TEST="$SCRIPT_DIR"/../bcs
+
+# Output files
+#shellcheck disable=SC2155
+declare -r RESULTS_FILE=${TESTNAME}_results_$(printf '%(%F_%T)T').txt
+
+# Kernel's most recently allocated PID: its advance over a run counts forks
+declare -r LAST_PID=/proc/sys/kernel/ns_last_pid
+
+# Variants: scan/ has no rules.idx, index/ has a fresh one, snapshot/ is
+# indexed and also keeps the serialised tier cache (BCS_TIER_CACHE) warm
+declare -ar VARIANTS=(scan index snapshot)
+declare -Ar VARIANT_LABELS=([scan]='section scan' [index]='rule index' [snapshot]='tier snapshot')
+
+# Test results storage
+declare -a times_scan times_index times_snapshot
+declare -A forks=()
+
+# Scratch installs, one per variant
+declare -- TMPDIR_BENCH=''
+
+##
+## FUNCTIONS
+##
+
+error() { >&2 printf '%s: ✗ %s\n' "$SCRIPT_NAME" "$*"; }
+die() { (($# < 2)) || error "${@:2}"; exit "${1:-0}"; }
+noarg() {
+  if (($# <= 1)) || [[ ${2:0:1} == '-' ]]; then
+    die 22 "Option ${1@Q} requires an argument"
+  fi
+}
+
+show_help() {
+  cat <<HELP
+$SCRIPT_NAME $VERSION - Rule loading: section scan vs. rule index vs. tier snapshot
+
+Measures the wall time and process forks of bcs(1) commands that load
+the rules, against three scratch installs of bcs and data/:
+
+  section scan    no rules.idx, BCS_TIER_CACHE=0: every section file is
+                  read and regex-matched
+  rule index      the rules.idx 'bcs generate' writes (code -> tier,
+                  title, section file, byte offset/length), no snapshot
+  tier snapshot   the index plus the serialised tier cache, a sourced
+                  'declare' snapshot under XDG_CACHE_HOME (kept warm)
+
+Commands timed:
+  bcs codes                          list every rule with its tier
+  bcs codes -E BCS1206               print one rule body (--explain)
+  bcs check --engine static FILE     start-up of a check (no model call)
+
+Forks are counted from the advance of $LAST_PID over a
+run, minus the bcs process itself -- exact on an idle host, an upper
+bound on a busy one.
+
+Default run: 3 test series at 20 calls each.
+With -i NUM: the same series at NUM calls each.
+Each test series repeats RUNS_PER_TEST times and reports mean/median/stddev.
+
+Usage: $SCRIPT_NAME [OPTIONS]
+
+Options:
+  -h, --help       Show this help and exit
+  -V, --version    Show version and exit
+  -i NUM           Calls per run (default: 20)
+  -r NUM           Runs per test series (default: 10)
+  -b FILE          bcs script to measure (default: ../bcs); point it at an
+                   older release to compare before/after
+
+Output:
+  stdout           Live progress, per-series results, forks per call
+  file             ${TESTNAME}_results_YYYY-MM-DD_HH:MM:SS.txt
+                   (system info, raw numbers, analysis)
+
+Exit codes:
+  0  success
+  2  unexpected positional argument
+  3  bcs script or its data/ directory not found
+ 22  unknown option or missing option argument
+
+HELP
+}
+
+print_system_info() {
+  cat <<SYSINFO
+System Information
+==================
+Date: $(date -Iseconds)
+Hostname: $(hostname)
+Bash Version: $BASH_VERSION
+CPU: $(grep -m1 'model name' /proc/cpuinfo | cut -d: -f2 | xargs)
+Kernel: $(uname -r)
+bcs: $BCS_UNDER_TEST ($("$BCS_UNDER_TEST" --version 2>/dev/null || echo unknown))
+Runs per test: $RUNS_PER_TEST
+
+SYSINFO
+}
+
+cleanup() {
+  [[ -z $TMPDIR_BENCH ]] || rm -rf -- "$TMPDIR_BENCH"
+}
+
+setup_installs() {
+  # One scratch install of the bcs under test per variant; bcs finds data/
+  # beside itself. A bcs predating the index or snapshot simply runs its
+  # own loader in every variant.
+  TMPDIR_BENCH=$(mktemp -d -t bench-rule-index-XXXXX)
+  local -- variant
+  for variant in "${VARIANTS[@]}"; do
+    mkdir -p "$TMPDIR_BENCH/$variant"/data "$TMPDIR_BENCH/$variant"/cache
+    install -m 755 -- "$BCS_UNDER_TEST" "$TMPDIR_BENCH/$variant"/bcs
+    cp -- "$BCS_DIR"/data/[0-9]*.md "$TMPDIR_BENCH/$variant"/data/
+    [[ $variant == scan ]] \
+      || "$TMPDIR_BENCH/$variant"/bcs generate -q -o "$TMPDIR_BENCH"/std.md
+  done
+  rm -f -- "$TMPDIR_BENCH"/scan/data/rules.idx
+  printf '#!/bin/bash\nset -euo pipefail\necho hi\n#fin\n' > "$TMPDIR_BENCH"/script.sh
+  # Warm the snapshot, then let the clock move past the sources' mtimes
+  sleep 0.05
+  XDG_CACHE_HOME="$TMPDIR_BENCH"/snapshot/cache "$TMPDIR_BENCH"/snapshot/bcs codes >/dev/null
+}
+
+run_benchmark() {
+  # Benchmark: $iterations calls of bcs ($variant install) with $args
+  # Prints "elapsed_us forks_per_call"
+  local -r variant=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i i start end pid_before=0 pid_after=0
+  local -r bcs="$TMPDIR_BENCH/$variant"/bcs
+  local -i tier_cache=0
+  [[ $variant != snapshot ]] || tier_cache=1
+  local -x XDG_CACHE_HOME="$TMPDIR_BENCH/$variant"/cache BCS_TIER_CACHE=$tier_cache
+
+  [[ ! -r $LAST_PID ]] || read -r pid_before < "$LAST_PID"
+  start=${EPOCHREALTIME/./}
+
+  i=-$iterations
+  #bcscheck disable=BCS0505
+  while ((1)); do
+    ((i++)) || break
+    "$bcs" "${args[@]}" &>/dev/null ||:
+  done
+
+  end=${EPOCHREALTIME/./}
+  [[ ! -r $LAST_PID ]] || read -r pid_after < "$LAST_PID"
+
+  echo "$((end - start)) $(( (pid_after - pid_before) / iterations - 1 ))"
+}
+
+calculate_statistics() {
+  # Calculate mean, median, stddev from array of values (microseconds)
+  local -n values=$1
+  local -i sum=0 count=${#values[@]} val=0
+  local -a sorted
+  local -i mean median variance sum_sq_diff stddev
+
+  for val in "${values[@]}"; do
+    sum+=val
+  done
+  mean=$((sum / count))
+
+  mapfile -t sorted < <(printf '%s\n' "${values[@]}" | sort -n)
+  if ((count % 2 == 0)); then
+    median=$(( (sorted[count/2-1] + sorted[count/2]) / 2 ))
+  else
+    median=${sorted[count/2]}
+  fi
+
+  sum_sq_diff=0
+  for val in "${values[@]}"; do
+    ((sum_sq_diff += (val - mean) * (val - mean)))
+  done
+  variance=$((sum_sq_diff / count))
+  stddev=$(awk "BEGIN {printf \"%.0f\", sqrt($variance)}")
+
+  # Return: mean median stddev (in microseconds)
+  echo "$mean $median $stddev"
+}
+
+format_time() {
+  # Convert microseconds to milliseconds per call
+  local -i us=$1 calls=$2
+  awk "BEGIN {printf \"%.1fms\", $us/$calls/1000}"
+}
+
+run_test_series() {
+  local -r test_name=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i run
+  local -- result variant
+
+  echo "Running test: $test_name (calls: $iterations, runs: $RUNS_PER_TEST)"
+  echo '========================================================================'
+
+  times_scan=()
+  times_index=()
+  times_snapshot=()
+  for ((run=1; run<=RUNS_PER_TEST; run+=1)); do
+    for variant in "${VARIANTS[@]}"; do
+      local -n times=times_$variant
+      printf '\rRun %2d/%d: Testing %-14s' "$run" "$RUNS_PER_TEST" "${VARIANT_LABELS[$variant]}..."
+      result=$(run_benchmark "$variant" "$iterations" "${args[@]}")
+      times+=("${result% *}")
+      forks[$variant]=${result#* }
+      unset -n times
+    done
+  done
+  printf '\rRun %2d/%d: Complete!                  \n' "$RUNS_PER_TEST" "$RUNS_PER_TEST"
+
+  # Display results (per call)
+  local -A mean=()
+  local -a stats
+  echo
+  echo "Results for: $test_name"
+  echo '-------------------------------------------'
+  printf '%-16s %12s %12s %12s %8s\n' Loader Mean Median StdDev Forks
+  echo "Test: $test_name (calls per run: $iterations)" >> "$RESULTS_FILE"
+  for variant in "${VARIANTS[@]}"; do
+    IFS=' ' read -ra stats <<<"$(calculate_statistics "times_$variant")"
+    mean[$variant]=${stats[0]}
+    printf '%-16s %12s %12s %12s %8s\n' "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}"
+    printf '%-13s - Mean: %s, Median: %s, StdDev: %s, Forks/call: %s\n' "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}" >> "$RESULTS_FILE"
+  done
+
+  # Guard against degenerate 0 µs measurements
+  local -i fastest=${mean[snapshot]}
+  ((fastest)) || fastest=1
+  local -- ratio
+  ratio=$(awk "BEGIN {printf \"%.1f\", ${mean[scan]}/$fastest}")
+  printf '\n◉ Tier snapshot is %sx faster than the section scan\n' "$ratio"
+
+  echo
+  echo '========================================================================'
+  echo
+
+  { echo "Speedup (scan -> snapshot): ${ratio}x"
+    echo
+  } >> "$RESULTS_FILE"
+}
+
+##
+## EXECUTION
+##
+
+main() {
+  local -i iterations=20
+
+  # Argument parsing
+  while (($#)); do
+    case $1 in
+      -h|--help)    show_help; exit 0 ;;
+      -V|--version) printf '%s %s\n' "$SCRIPT_NAME" "$VERSION"; exit 0 ;;
+      -i)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -i requires a positive integer, got ${1@Q}"
+                    iterations=$1 ;;
+      -r)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -r requires a positive integer, got ${1@Q}"
+                    RUNS_PER_TEST=$1 ;;
+      -b)           noarg "$@"; shift; BCS_UNDER_TEST=$1 ;;
+      --)           shift; break ;;
+      -[hVirb]?*)   set -- "${1:0:2}" "-${1:2}" "${@:2}"; continue ;;
+      -*)           die 22 "Unknown option ${1@Q}" ;;
+      *)            die 2 "Unexpected argument ${1@Q}" ;;
+    esac
+    shift
+  done
+  readonly RUNS_PER_TEST
+
+  [[ -f $BCS_UNDER_TEST ]] || die 3 "bcs not found at ${BCS_UNDER_TEST@Q}"
+  # Section files come from the checkout this benchmark lives in
+  declare -gr BCS_DIR="$SCRIPT_DIR"/..
+  [[ -d $BCS_DIR/data ]] || die 3 "No data directory in ${BCS_DIR@Q}"
+
+  trap cleanup EXIT
+  setup_installs
+
+  { print_system_info
+    echo "Starting benchmarks: 3 test series at ${iterations} calls (${RUNS_PER_TEST} runs each)"
+    echo
+  } | tee "$RESULTS_FILE"
+
+  run_test_series "bcs codes (${iterations})" "$iterations" codes
+  run_test_series "bcs codes -E BCS1206 (${iterations})" "$iterations" codes -E BCS1206
+  run_test_series "bcs check --engine static (${iterations})" "$iterations" \
+    check --engine static --no-cache --no-shellcheck "$TMPDIR_BENCH"/script.sh
+
+  { cat <<SUMMARY
+Benchmark Complete
+==================
+
+Detailed results saved to: $RESULTS_FILE
+
+Analysis:
+---------
+Without an index, every command that needs tiers concatenates the
+section files and regex-matches each line, and --explain greps them one
+by one before awk prints the body. With rules.idx, one read loads every
+code's tier, title and byte range; --explain reads straight to the rule
+body. The tier snapshot replaces even that read loop with sourcing a
+few 'declare' lines, validated by [[ -nt ]] tests alone.
+
+Times are per call and include the rest of bcs start-up (config
+cascade, policy), which all variants share. Fork counts are per call;
+run with -b against an older bcs to see the one-fork-per-rule listing
+the index replaced.
+
+SUMMARY
+  } | tee -a "$RESULTS_FILE"
+
+  echo
+  echo "Results saved to ${RESULTS_FILE@Q}"
+}
+
+main "$@"
+
+#fin
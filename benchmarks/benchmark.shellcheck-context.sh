@@ -0,0 +1,414 @@
+#!/usr/bin/bash
+# shellcheck disable=SC2034
+# benchmark-shellcheck-context.sh - Cost of the shellcheck prelude in single- and multi-file checks
+set -euo pipefail
+shopt -s inherit_errexit shift_verbose extglob nullglob
+
+##
+## INITIALIZATION
+##
+
+# Script metadata
+declare -r VERSION=1.0.0 # 2026-10-16 - Initial version
+declare -r SCRIPT_NAME=${0##*/}
+#shellcheck disable=SC2155
+declare -r SCRIPT_DIR=$(cd -P -- "${0%/*}" && pwd -P)
+
+# Test name derived from script filename: 'benchmark.X.sh' → 'X'
+declare -- TESTNAME=${SCRIPT_NAME#benchmark.}
+TESTNAME=${TESTNAME%.sh}
+declare -r TESTNAME
+
+# Configuration
+declare -i RUNS_PER_TEST=10
+declare -- BCS_UNDER_TEST="$SCRIPT_DIR"/../bcs BCS_BASELINE=''
+declare -- FIXTURES="$SCRIPT_DIR"/../tests/fixtures
+declare -i SC_COST_MS=150
+
+# Output files
+#shellcheck disable=SC2155
+declare -r RESULTS_FILE=${TESTNAME}_results_$(printf '%(%F_%T)T').txt
+
+# Kernel's most recently allocated PID: its advance over a run counts forks
+declare -r LAST_PID=/proc/sys/kernel/ns_last_pid
+
+# Builds measured: the bcs under test, and with -b a baseline to compare
+declare -a VARIANTS=(current)
+declare -Ar VARIANT_LABELS=([baseline]='baseline' [current]='current')
+
+# Test results storage
+declare -a times_baseline times_current
+declare -A forks=() sc_runs=()
+
+# Scratch installs, mock responses and the shellcheck stand-in
+declare -- TMPDIR_BENCH=''
+
+##
+## FUNCTIONS
+##
+
+error() { >&2 printf '%s: ✗ %s\n' "$SCRIPT_NAME" "$*"; }
+die() { (($# < 2)) || error "${@:2}"; exit "${1:-0}"; }
+noarg() {
+  if (($# <= 1)) || [[ ${2:0:1} == '-' ]]; then
+    die 22 "Option ${1@Q} requires an argument"
+  fi
+}
+
+show_help() {
+  cat <<HELP
+$SCRIPT_NAME $VERSION - Cost of the shellcheck prelude in single- and multi-file checks
+
+Measures the wall time, process forks and shellcheck runs of 'bcs check'
+with the shellcheck context on, against the offline mock backend
+(-m mock:DIR) so the model costs nothing:
+
+  single    bcs check --no-cache -m mock:DIR FILE
+  multi     bcs check --no-cache -P 4 -m mock:DIR FILE x 8
+  cached    bcs check -e high -m mock:DIR FILE x 8, after a warm-up
+            with -e low: the result cache misses, the report cache hits
+
+shellcheck is a stand-in in the scratch \$HOME/.local/bin (first on
+bcs's hardened PATH) that sleeps SC_COST_MS per run -- the start-up and
+source-parsing cost that dominates real shellcheck on scripts with many
+'source' targets -- then reports one finding per file. The series thus
+isolate how often, and on which path, bcs pays that cost.
+
+Forks are counted from the advance of $LAST_PID over a
+run, minus the bcs process itself -- exact on an idle host, an upper
+bound on a busy one. shellcheck runs are counted in one extra pass per
+series (not timed). Every run uses a scratch HOME, so no user bcs.conf
+or policy.conf applies.
+
+Default run: 3 test series at 5 calls each.
+With -i NUM: the same series at NUM calls each.
+Each test series repeats RUNS_PER_TEST times and reports mean/median/stddev.
+
+Usage: $SCRIPT_NAME [OPTIONS]
+
+Options:
+  -h, --help       Show this help and exit
+  -V, --version    Show version and exit
+  -i NUM           Calls per run (default: 5)
+  -r NUM           Runs per test series (default: 10)
+  -b FILE          Baseline bcs script measured alongside ../bcs, e.g. an
+                   older release (git show REV:bcs > FILE)
+  -c MS            Cost of one stand-in shellcheck run (default: 150)
+
+Output:
+  stdout           Live progress, per-series results, forks and shellcheck runs per call
+  file             ${TESTNAME}_results_YYYY-MM-DD_HH:MM:SS.txt
+                   (system info, raw numbers, analysis)
+
+Exit codes:
+  0  success
+  2  unexpected positional argument
+  3  bcs script, its data/ directory or the test fixtures not found
+ 22  unknown option or missing option argument
+
+HELP
+}
+
+print_system_info() {
+  cat <<SYSINFO
+System Information
+==================
+Date: $(date -Iseconds)
+Hostname: $(hostname)
+Bash Version: $BASH_VERSION
+jq: $(jq --version)
+CPU: $(grep -m1 'model name' /proc/cpuinfo | cut -d: -f2 | xargs)
+Kernel: $(uname -r)
+bcs: $BCS_UNDER_TEST
+baseline: ${BCS_BASELINE:-(none)}
+Checked scripts: ${FILES[*]##*/}
+shellcheck stand-in cost: ${SC_COST_MS}ms per run
+Runs per test: $RUNS_PER_TEST
+
+SYSINFO
+}
+
+cleanup() {
+  [[ -z $TMPDIR_BENCH ]] || rm -rf -- "$TMPDIR_BENCH"
+}
+
+setup_installs() {
+  # One scratch install per build (bcs finds data/ beside itself), with a
+  # fresh rule index so both load the rules the same way
+  TMPDIR_BENCH=$(mktemp -d -t bench-shellcheck-context-XXXXX)
+  local -- variant src
+  for variant in "${VARIANTS[@]}"; do
+    src=$BCS_UNDER_TEST
+    [[ $variant == current ]] || src=$BCS_BASELINE
+    mkdir -p "$TMPDIR_BENCH/$variant"/data "$TMPDIR_BENCH/$variant"/cache \
+             "$TMPDIR_BENCH/$variant"/state
+    install -m 755 -- "$src" "$TMPDIR_BENCH/$variant"/bcs
+    cp -- "$BCS_DIR"/data/[0-9]*.md "$TMPDIR_BENCH/$variant"/data/
+    "$TMPDIR_BENCH/$variant"/bcs generate -q
+  done
+
+  # Recorded answer: a clean report, so every call exits the same way
+  mkdir -p "$TMPDIR_BENCH"/mock
+  printf '%s\n' 'No findings.' '___TOKENS___ in=9000 out=4' > "$TMPDIR_BENCH"/mock/default.txt
+
+  # Scratch home with the shellcheck stand-in: logs one line per run,
+  # sleeps SC_COST_MS, reports one finding per file
+  mkdir -p "$TMPDIR_BENCH"/home/.local/bin
+  cat > "$TMPDIR_BENCH"/home/.local/bin/shellcheck <<STUB
+#!/bin/bash
+[[ \$1 == --version ]] && { echo 'version: 0.0-bench'; exit 0; }
+echo >> "\$SC_COUNT_FILE"
+sleep $(printf '%d.%03d' $((SC_COST_MS / 1000)) $((SC_COST_MS % 1000)))
+shift 3
+out='[' sep=''
+for f; do out+="\$sep{\"file\":\"\$f\",\"line\":1,\"column\":1,\"level\":\"info\",\"code\":2148,\"message\":\"m\"}"; sep=,; done
+echo "\$out]"
+exit 1
+STUB
+  chmod 755 "$TMPDIR_BENCH"/home/.local/bin/shellcheck
+}
+
+run_benchmark() {
+  # Benchmark: $iterations checks by bcs ($variant install) with $args
+  # Prints "elapsed_us forks_per_call"
+  local -r variant=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i i start end pid_before=0 pid_after=0
+  local -r bcs="$TMPDIR_BENCH/$variant"/bcs
+  local -x HOME="$TMPDIR_BENCH"/home SC_COUNT_FILE=/dev/null
+  local -x XDG_CACHE_HOME="$TMPDIR_BENCH/$variant"/cache XDG_STATE_HOME="$TMPDIR_BENCH/$variant"/state
+
+  [[ ! -r $LAST_PID ]] || read -r pid_before < "$LAST_PID"
+  start=${EPOCHREALTIME/./}
+
+  i=-$iterations
+  #bcscheck disable=BCS0505
+  while ((1)); do
+    ((i++)) || break
+    "$bcs" "${args[@]}" &>/dev/null ||:
+  done
+
+  end=${EPOCHREALTIME/./}
+  [[ ! -r $LAST_PID ]] || read -r pid_after < "$LAST_PID"
+
+  echo "$((end - start)) $(( (pid_after - pid_before) / iterations - 1 ))"
+}
+
+count_sc_runs() {
+  # shellcheck runs started by one check of bcs ($variant install) with $args
+  local -r variant=$1
+  local -a args=("${@:2}")
+  local -x XDG_CACHE_HOME="$TMPDIR_BENCH/$variant"/cache XDG_STATE_HOME="$TMPDIR_BENCH/$variant"/state
+  local -x HOME="$TMPDIR_BENCH"/home SC_COUNT_FILE="$TMPDIR_BENCH"/sc.count
+  : > "$SC_COUNT_FILE"
+  "$TMPDIR_BENCH/$variant"/bcs "${args[@]}" &>/dev/null ||:
+  wc -l < "$SC_COUNT_FILE"
+}
+
+calculate_statistics() {
+  # Calculate mean, median, stddev from array of values (microseconds)
+  local -n values=$1
+  local -i sum=0 count=${#values[@]} val=0
+  local -a sorted
+  local -i mean median variance sum_sq_diff stddev
+
+  for val in "${values[@]}"; do
+    sum+=val
+  done
+  mean=$((sum / count))
+
+  mapfile -t sorted < <(printf '%s\n' "${values[@]}" | sort -n)
+  if ((count % 2 == 0)); then
+    median=$(( (sorted[count/2-1] + sorted[count/2]) / 2 ))
+  else
+    median=${sorted[count/2]}
+  fi
+
+  sum_sq_diff=0
+  for val in "${values[@]}"; do
+    ((sum_sq_diff += (val - mean) * (val - mean)))
+  done
+  variance=$((sum_sq_diff / count))
+  stddev=$(awk "BEGIN {printf \"%.0f\", sqrt($variance)}")
+
+  # Return: mean median stddev (in microseconds)
+  echo "$mean $median $stddev"
+}
+
+format_time() {
+  # Convert microseconds to milliseconds per call
+  local -i us=$1 calls=$2
+  awk "BEGIN {printf \"%.1fms\", $us/$calls/1000}"
+}
+
+run_test_series() {
+  local -r test_name=$1
+  local -ri iterations=$2
+  local -a args=("${@:3}")
+  local -i run
+  local -- result variant
+
+  echo "Running test: $test_name (calls: $iterations, runs: $RUNS_PER_TEST)"
+  echo '========================================================================'
+
+  times_baseline=()
+  times_current=()
+  for variant in "${VARIANTS[@]}"; do
+    sc_runs[$variant]=$(count_sc_runs "$variant" "${args[@]}")
+  done
+  for ((run=1; run<=RUNS_PER_TEST; run+=1)); do
+    for variant in "${VARIANTS[@]}"; do
+      local -n times=times_$variant
+      printf '\rRun %2d/%d: Testing %-10s' "$run" "$RUNS_PER_TEST" "${VARIANT_LABELS[$variant]}..."
+      result=$(run_benchmark "$variant" "$iterations" "${args[@]}")
+      times+=("${result% *}")
+      forks[$variant]=${result#* }
+      unset -n times
+    done
+  done
+  printf '\rRun %2d/%d: Complete!             \n' "$RUNS_PER_TEST" "$RUNS_PER_TEST"
+
+  # Display results (per call)
+  local -A mean=()
+  local -a stats
+  echo
+  echo "Results for: $test_name"
+  echo '-------------------------------------------'
+  printf '%-10s %12s %12s %12s %8s %8s\n' Build Mean Median StdDev Forks 'sc runs'
+  echo "Test: $test_name (calls per run: $iterations)" >> "$RESULTS_FILE"
+  for variant in "${VARIANTS[@]}"; do
+    IFS=' ' read -ra stats <<<"$(calculate_statistics "times_$variant")"
+    mean[$variant]=${stats[0]}
+    printf '%-10s %12s %12s %12s %8s %8s\n' "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}" "${sc_runs[$variant]}"
+    printf '%-8s - Mean: %s, Median: %s, StdDev: %s, Forks/call: %s, shellcheck runs/call: %s\n' \
+      "${VARIANT_LABELS[$variant]}" \
+      "$(format_time "${stats[0]}" "$iterations")" \
+      "$(format_time "${stats[1]}" "$iterations")" \
+      "$(format_time "${stats[2]}" "$iterations")" "${forks[$variant]}" "${sc_runs[$variant]}" \
+      >> "$RESULTS_FILE"
+  done
+
+  if [[ -n ${mean[baseline]:-} ]]; then
+    # Guard against degenerate 0 µs measurements
+    local -i fastest=${mean[current]}
+    ((fastest)) || fastest=1
+    local -- ratio
+    ratio=$(awk "BEGIN {printf \"%.2f\", ${mean[baseline]}/$fastest}")
+    printf '\n◉ current is %sx the speed of baseline, %d fewer forks per check\n' \
+      "$ratio" $((forks[baseline] - forks[current]))
+    { echo "Speedup (baseline -> current): ${ratio}x"
+      echo
+    } >> "$RESULTS_FILE"
+  else
+    echo >> "$RESULTS_FILE"
+  fi
+
+  echo
+  echo '========================================================================'
+  echo
+}
+
+##
+## EXECUTION
+##
+
+main() {
+  local -i iterations=5
+
+  # Argument parsing
+  while (($#)); do
+    case $1 in
+      -h|--help)    show_help; exit 0 ;;
+      -V|--version) printf '%s %s\n' "$SCRIPT_NAME" "$VERSION"; exit 0 ;;
+      -i)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -i requires a positive integer, got ${1@Q}"
+                    iterations=$1 ;;
+      -r)           noarg "$@"; shift
+                    [[ $1 =~ ^[1-9][0-9]*$ ]] \
+                      || die 22 "Option -r requires a positive integer, got ${1@Q}"
+                    RUNS_PER_TEST=$1 ;;
+      -b)           noarg "$@"; shift; BCS_BASELINE=$1 ;;
+      -c)           noarg "$@"; shift
+                    [[ $1 =~ ^[0-9]+$ ]] \
+                      || die 22 "Option -c requires a non-negative integer, got ${1@Q}"
+                    SC_COST_MS=$1 ;;
+      --)           shift; break ;;
+      -[hVirbc]?*)  set -- "${1:0:2}" "-${1:2}" "${@:2}"; continue ;;
+      -*)           die 22 "Unknown option ${1@Q}" ;;
+      *)            die 2 "Unexpected argument ${1@Q}" ;;
+    esac
+    shift
+  done
+  readonly RUNS_PER_TEST
+
+  [[ -f $BCS_UNDER_TEST ]] || die 3 "bcs not found at ${BCS_UNDER_TEST@Q}"
+  if [[ -n $BCS_BASELINE ]]; then
+    [[ -f $BCS_BASELINE ]] || die 3 "Baseline bcs not found at ${BCS_BASELINE@Q}"
+    VARIANTS=(baseline current)
+  fi
+  readonly VARIANTS
+  local -a fixtures=("$FIXTURES"/0[1-8]-*.sh)
+  ((${#fixtures[@]} == 8)) || die 3 "Expected 8 fixtures 01-08 in ${FIXTURES@Q}"
+  declare -ga FILES
+  readarray -t FILES < <(realpath -- "${fixtures[@]}")
+  # Section files come from the checkout this benchmark lives in
+  declare -gr BCS_DIR="$SCRIPT_DIR"/..
+  [[ -d $BCS_DIR/data ]] || die 3 "No data directory in ${BCS_DIR@Q}"
+
+  trap cleanup EXIT
+  setup_installs
+
+  { print_system_info
+    echo "Starting benchmarks: 3 test series at ${iterations} calls (${RUNS_PER_TEST} runs each)"
+    echo
+  } | tee "$RESULTS_FILE"
+
+  local -a common=(--shellcheck -m mock:"$TMPDIR_BENCH"/mock)
+  local -- variant
+  run_test_series "single (${iterations})" "$iterations" \
+    check --no-cache "${common[@]}" "${FILES[0]}"
+  run_test_series "multi x8 (${iterations})" "$iterations" \
+    check --no-cache -P 4 "${common[@]}" "${FILES[@]}"
+  # Warm both caches once; every timed call is then a result-cache hit
+  for variant in "${VARIANTS[@]}"; do
+    count_sc_runs "$variant" check -P 4 "${common[@]}" "${FILES[@]}" >/dev/null
+  done
+  run_test_series "cached x8 (${iterations})" "$iterations" \
+    check -P 4 "${common[@]}" "${FILES[@]}"
+
+  { cat <<SUMMARY
+Benchmark Complete
+==================
+
+Detailed results saved to: $RESULTS_FILE
+
+Analysis:
+---------
+bcs used to run shellcheck synchronously inside each file's check,
+before backend resolution and before the result-cache lookup: one run
+per file per call, even when the cached result was then replayed
+without using it. Now cmd_check keys each report by the shellcheck
+version and the bytes of the script and everything it sources, and
+starts one background shellcheck over all files without a cached
+report; each check collects its slice only when it is about to call the
+model. The multi-file series pays the stand-in cost once instead of
+once per file (spread over 4 workers), and the cached series not at
+all. In the single series the run overlaps the standard preparation and
+backend resolution, which are short next to a real shellcheck on a
+large script. Times are per call and include bcs start-up.
+
+SUMMARY
+  } | tee -a "$RESULTS_FILE"
+
+  echo
+  echo "Results saved to ${RESULTS_FILE@Q}"
+}
+
+main "$@"
+
+#fin
@@ -0,0 +1,215 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# lib/batch.bash - bcs module. Provider batch jobs for bcs check
+# --batch-submit and --batch-collect: the request spool, job submission
+# through the batch endpoints, and the replay of collected answers through
+# the ordinary check path.
+# Sourced by bcs on first use (_bcs_module): functions only, reading and
+# setting bcs's globals and their callers' locals (hence SC2034/SC2154).
+#shellcheck shell=bash disable=SC2034,SC2154
+
+# ---- Batch API (--batch-submit / --batch-collect) ----
+
+# Batch request id for a script: custom_id in the job, file name in the
+# spool and replay directories. Keyed on the path and the content, so an
+# answer is never replayed against a script edited since submission.
+_batch_id() {
+  local -- sum
+  sum=$(sha256sum < "$1") || return 1
+  printf '%s\0%s' "$1" "${sum%% *}" | sha256sum | cut -c1-32
+}
+
+# Fingerprint of what a batch request reviewed for script $1: its sha256
+# and, under --since REF $2, the changed ranges (or the _changed_ranges
+# status when there are none to compute). Recorded at submit and compared
+# at collect.
+_batch_source() {
+  local -- sum
+  sum=$(sha256sum < "$1") || return 1
+  printf '%s\n' "${sum%% *}"
+  [[ -z $2 ]] || _changed_ranges "$2" "$1" || echo "status $?"
+}
+
+# Capture the payload a backend built for the current script_file into
+# BCS_BATCH_SPOOL as <id>.<backend>, instead of sending it. Backends call
+# it under --batch-submit, when BCS_BATCH_SPOOL is set.
+_batch_spool() {
+  printf '%s\n' "$2" > "$BCS_BATCH_SPOOL/$(_batch_id "$script_file").$1"
+}
+
+# Call batch endpoint URL $2 of backend $1 through _http_post, with any
+# further curl arguments; JSON payload on stdin, or empty stdin for a GET.
+# Prints the response body; dies 5 on failure.
+_batch_http() {
+  local -- backend=$1 url=$2 raw body
+  shift 2
+  case $backend in
+    anthropic)
+      [[ -n ${ANTHROPIC_API_KEY:-} ]] || die 18 'ANTHROPIC_API_KEY not set'
+      raw=$(_http_post anthropic "header = \"x-api-key: $ANTHROPIC_API_KEY\"" --max-time 300 \
+              -H 'anthropic-version: 2023-06-01' "$@" "$url") ;;
+    openai)
+      [[ -n ${OPENAI_API_KEY:-} ]] || die 18 'OPENAI_API_KEY not set'
+      raw=$(_http_post openai "header = \"Authorization: Bearer $OPENAI_API_KEY\"" --max-time 300 \
+              "$@" "$url") ;;
+  esac || die 5 "Batch API connection failed ($backend)"
+  local -i code
+  code=$(_curl_status "${raw##*___CURL___ }")
+  body=${raw%$'\n___CURL___ '*}
+  if ! ((code >= 200 && code < 300)); then
+    die 5 "Batch API error (HTTP $code)" "$(jq -r '.error.message // empty' <<< "$body" 2>/dev/null ||:)"
+  fi
+  printf '%s\n' "$body"
+}
+
+# Submit the payloads spooled by a --batch-submit run as one provider
+# batch job and record it under $(_state_root)/batches/ID.json with the
+# settings and files needed to render the results later. Reads cmd_check's
+# option locals; $1 is the user's cache setting. Prints the batch id.
+_batch_submit() {
+  local -- spool=$BCS_BATCH_SPOOL backend body id
+  local -a spooled=("$spool"/*.*)
+  ((${#spooled[@]})) || die 5 'No requests to submit'
+  backend=${spooled[0]##*.}
+  case $backend in
+    anthropic)
+      body=$(jq -nc '{requests: [inputs | {custom_id: (input_filename | split("/")[-1] | split(".")[0]),
+                                           params: .}]}' "${spooled[@]}" \
+             | _batch_http anthropic "${ANTHROPIC_BASE_URL:-https://api.anthropic.com}"/v1/messages/batches \
+                 -H 'Content-Type: application/json') ;;
+    openai)
+      jq -c '{custom_id: (input_filename | split("/")[-1] | split(".")[0]), method: "POST",
+              url: "/v1/chat/completions", body: .}' "${spooled[@]}" > "$spool"/batch.jsonl
+      body=$(_batch_http openai "${OPENAI_BASE_URL:-https://api.openai.com}"/v1/files \
+               -F purpose=batch -F file=@"$spool"/batch.jsonl < /dev/null)
+      body=$(jq -c '{input_file_id: .id, endpoint: "/v1/chat/completions", completion_window: "24h"}' \
+               <<< "$body" \
+             | _batch_http openai "${OPENAI_BASE_URL:-https://api.openai.com}"/v1/batches \
+                 -H 'Content-Type: application/json') ;;
+  esac
+  id=$(jq -r '.id // empty' <<< "$body")
+  [[ $id =~ ^[A-Za-z0-9_-]+$ ]] || die 5 'Batch API returned no usable batch id'
+
+  local -- state_dir f
+  state_dir=$(_state_root)/batches
+  mkdir -p -- "$state_dir" || die 1 "Cannot create ${state_dir@Q}"
+  local -a sources=()
+  for f in "${script_files[@]}"; do
+    sources+=("$f" "$(_batch_source "$f" "$since_ref")")
+  done
+  jq -n --arg id "$id" --arg backend "$backend" --arg model "$model" --arg effort "$effort" \
+    --argjson strict "$strict" --argjson json "$json_output" --arg format "$format" \
+    --argjson shellcheck "$shellcheck_ctx" \
+    --argjson cache "$1" --arg tier "$tier_filter" --arg min_tier "$min_tier_filter" \
+    --arg engine "$engine" --arg since "$since_ref" \
+    '{id: $id, backend: $backend, submitted: (now | todate), model: $model, effort: $effort,
+      strict: ($strict == 1), json: ($json == 1), format: $format, shellcheck: ($shellcheck == 1),
+      cache: ($cache == 1), tier: $tier, min_tier: $min_tier, engine: $engine, since: $since,
+      files: [$ARGS.positional | range(0; length; 2) as $i | .[$i]],
+      sources: [$ARGS.positional | range(0; length; 2) as $i | {file: .[$i], source: .[$i + 1]}]}' \
+    --args "${sources[@]}" > "$state_dir/$id".json
+  printf '%s\n' "$id"
+  success "Submitted ${#spooled[@]} scripts as $backend batch $id" \
+          "Collect with: $SCRIPT_NAME check --batch-collect $id"
+}
+
+# Fetch the results of batch $1 and render them per file by re-running the
+# recorded check with each model call replayed from the batch (see
+# _llm_review), so output, exit status and caching match a live run.
+# A script whose content or --since ranges changed since submission is
+# not rendered (nor cached) and the collect returns 3. Returns 11 (EAGAIN)
+# while the job is still processing.
+_batch_collect() {
+  local -- id=$1 state body status results replay
+  state=$(_state_root)/batches/$id.json
+  [[ -f $state ]] || die 3 "Unknown batch ${id@Q} (no ${state@Q})"
+  local -- backend
+  backend=$(jq -r .backend "$state")
+  case $backend in
+    anthropic)
+      body=$(_batch_http anthropic \
+               "${ANTHROPIC_BASE_URL:-https://api.anthropic.com}/v1/messages/batches/$id" < /dev/null)
+      status=$(jq -r .processing_status <<< "$body")
+      [[ $status != ended ]] || results=$(_batch_http anthropic "$(jq -r .results_url <<< "$body")" < /dev/null) ;;
+    openai)
+      body=$(_batch_http openai "${OPENAI_BASE_URL:-https://api.openai.com}/v1/batches/$id" < /dev/null)
+      status=$(jq -r .status <<< "$body")
+      case $status in
+        completed) local -- fid
+                   results=''
+                   for fid in $(jq -r '.output_file_id // empty, .error_file_id // empty' <<< "$body"); do
+                     results+=$(_batch_http openai \
+                                  "${OPENAI_BASE_URL:-https://api.openai.com}/v1/files/$fid/content" < /dev/null)$'\n'
+                   done ;;
+        failed|expired|cancelled) die 5 "Batch $id $status" ;;
+      esac ;;
+  esac
+  if [[ $status != @(ended|completed) ]]; then
+    info "Batch $id: $status" "$(jq -r '(.request_counts // {}) | to_entries
+      | map("\(.value) \(.key)") | join(", ")' <<< "$body")"
+    return 11
+  fi
+
+  # One "custom_id NUL text NUL error NUL" record per result line; the text
+  # ends with the ___TOKENS___ line the live backends print.
+  replay=$(mktemp -d -t 'bcs-batch-XXXXX') || die 1 'Failed to create replay dir'
+  _register_tmp "$replay"
+  local -- cid text err
+  while IFS= read -r -d '' cid && IFS= read -r -d '' text && IFS= read -r -d '' err; do
+    if [[ -n $err ]]; then printf '%s\n' "$err" > "$replay/$cid".err
+    else printf '%s\n' "$text" > "$replay/$cid".out; fi
+  done < <(jq -j 'select(.custom_id) | .custom_id + "\u0000" +
+    (if .result then
+       (if .result.type == "succeeded" then
+          ([.result.message.content[]? | select(.text != null) | .text] | join(""))
+          + (.result.message.usage | "\n___TOKENS___ in=\(.input_tokens // 0) out=\(.output_tokens // 0)"
+             + " cache_creation=\(.cache_creation_input_tokens // 0) cache_read=\(.cache_read_input_tokens // 0)")
+            + "\u0000\u0000"
+        else "\u0000" + (.result.error.error.message // .result.error.message // .result.type) + "\u0000" end)
+     elif (.response.status_code // 0) == 200 then
+       (.response.body.choices[0].message.content // "")
+       + (.response.body.usage | "\n___TOKENS___ in=\(.prompt_tokens // 0) out=\(.completion_tokens // 0)")
+       + "\u0000\u0000"
+     else "\u0000" + (.error.message // .response.body.error.message // "request failed") + "\u0000" end)' \
+    <<< "$results")
+
+  local -a argv=()
+  readarray -d '' -t argv < <(jq -j '["-m", .model, "-e", .effort, "--engine", .engine, "--chunk-lines", "0",
+      (if .strict then "-s" else "-S" end),
+      (if .format then "--format", .format elif .json then "-j" else empty end),
+      (if .shellcheck then "--shellcheck" else "--no-shellcheck" end),
+      (if .cache then "--cache" else "--no-cache" end),
+      (if .tier != "" then "-T", .tier else empty end),
+      (if .min_tier != "" then "-M", .min_tier else empty end),
+      (if .since != "" then "--since", .since else empty end), "--"]
+    | map("\(.)\u0000") | add' "$state")
+
+  # Only scripts still as reviewed are rendered: an edited file would get
+  # the old answer against new line numbers and cache it under the new key.
+  local -- file source since
+  local -i stale=0
+  since=$(jq -r .since "$state")
+  while IFS= read -r -d '' file && IFS= read -r -d '' source; do
+    if [[ -f $file && $(_batch_source "$file" "$since") == "$source" ]]; then
+      argv+=("$file")
+    else
+      error "${file@Q} changed since batch $id was submitted; not rendered (check it again)"
+      stale+=1
+    fi
+  done < <(jq -j '.sources[] | .file + "\u0000" + .source + "\u0000"' "$state")
+  local -i rc=0
+  [[ ${argv[-1]} == -- ]] || BCS_BATCH_REPLAY=$replay cmd_check -P "$max_jobs" "${argv[@]}" || rc=$?
+  ((!stale || rc > 3)) || rc=3
+  jq '.collected = (now | todate)' "$state" > "$state.$$" && mv -f -- "$state.$$" "$state" ||:
+  return "$rc"
+}
+
+# --batch-collect: print the batch result for the current script_file.
+_batch_replay() {
+  local -- f
+  f=$BCS_BATCH_REPLAY/$(_batch_id "$script_file")
+  [[ ! -f $f.err ]] || die 5 "Batch request failed for ${script_file@Q}" "$(< "$f".err)"
+  [[ -f $f.out ]] || die 3 "No batch result for ${script_file@Q}"
+  cat -- "$f".out
+}
+#fin
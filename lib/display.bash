@@ -0,0 +1,62 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# lib/display.bash - bcs module. Display cache: rendered copies of the
+# standard kept per document digest, terminal width and TERM, so bcs
+# display skips md2ansi.
+# Sourced by bcs on first use (_bcs_module): functions only, reading and
+# setting bcs's globals and their callers' locals (hence SC2034/SC2154).
+#shellcheck shell=bash disable=SC2034,SC2154
+
+# ---- Rendered standard cache (display) ----
+
+# md2ansi renders the standard one line at a time in Bash -- seconds for
+# the whole document -- so bcs display keeps the output under the cache
+# dir, per document digest, terminal width and TERM (which sets colour):
+#   display/<sha256>/<width>.<TERM>.ansi
+# An entry older than md2ansi is stale. A hit goes straight to the pager;
+# generate re-renders the entries of a standard it replaces in the
+# background.
+
+# Set the caller's entry to the cache path of standard file $1 rendered
+# at width $2 for $TERM. Fails when the document cannot be hashed.
+_display_entry() {
+  local -- digest='' term=${TERM:-dumb}
+  if ! _standard_digest "$1"; then
+    digest=$(sha256sum < "$1" 2>/dev/null) || return 1
+    digest=${digest%% *}
+  fi
+  entry=${XDG_CACHE_HOME:-$HOME/.cache}/bcs/display/$digest/$2.${term//[!A-Za-z0-9_+-]/_}.ansi
+}
+
+# Render standard file $2 with md2ansi $1 at width $3 into cache entry $4:
+# a temp sibling first, renamed only once md2ansi has finished. Run in the
+# background, so it ignores the hangup of a terminal closed meanwhile.
+_display_render() {
+  local -- tmp
+  trap '' HUP
+  mkdir -p -- "${4%/*}" 2>/dev/null || return 0
+  tmp=$(mktemp "${4%/*}"/.tmp.XXXXXX 2>/dev/null) || return 0
+  if "$1" --width "$3" -- "$2" > "$tmp" 2>/dev/null; then
+    mv -f -- "$tmp" "$4"
+  else
+    rm -f -- "$tmp"
+  fi
+}
+
+# The standard $3 replaced the document with digest $1 by one with digest
+# $2: render the new one in the background for every width and TERM that
+# had an entry for the old one, and drop the old entries.
+_display_refresh() {
+  local -- root=${XDG_CACHE_HOME:-$HOME/.cache}/bcs/display md2ansi_cmd f name
+  [[ -n $1 && $1 != "$2" && -d $root/$1 ]] || return 0
+  if md2ansi_cmd=$(_find_md2ansi); then
+    for f in "$root/$1"/*.ansi; do
+      [[ -f $f ]] || continue
+      name=${f##*/} name=${name%.ansi}
+      TERM=${name#*.} _display_render "$md2ansi_cmd" "$3" "${name%%.*}" "$root/$2/${f##*/}" \
+        &>/dev/null </dev/null &
+    done
+  fi
+  rm -rf -- "${root:?}/$1"
+}
+#fin
@@ -0,0 +1,186 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# lib/estimate.bash - bcs module. Pre-flight estimates for check
+# --estimate and --auto-effort, calibrated from the run history.
+# Sourced by bcs on first use (_bcs_module): functions only, reading and
+# setting bcs's globals and their callers' locals (hence SC2034/SC2154).
+#shellcheck shell=bash disable=SC2034,SC2154
+
+# ---- Pre-flight estimates ----
+
+# Thinking tokens backend $1 may spend for model $2 at effort $3 -- the
+# same capability gating as _llm_anthropic and _llm_google. They count
+# against max_tokens, so the estimate reserves them in full.
+_thinking_budget() {
+  local -i budget=${EFFORT_THINKING[$3]:-0}
+  case $1 in
+    anthropic) [[ $2 == @(*opus*|*sonnet-4-6*|*sonnet-4-7*) ]] || budget=0 ;;
+    google)    [[ $2 == *-2.5-* && $2 != *flash-lite* ]] || budget=0 ;;
+    *)         budget=0 ;;
+  esac
+  echo "$budget"
+}
+
+# Forecast one check of a script with $1 lines as $3 requests of $2
+# prompt bytes at _check_file's backend, model, effort and output mode,
+# from the live API reviews in the run history (the records with prompt
+# bytes; see _run_record). Sets the caller's est array:
+#   [0] input tokens  [1] output tokens per request, before the thinking reserve
+#   [2] findings      [3] latency in ms per request (-1: no history)
+#   [4] bytes/token   [5] checks fitted for output  [6] for latency
+#   [7] output tokens per second
+# Input: prompt bytes over the bytes-per-token ratio of this model's (else
+# this backend's) history. Output: a least-squares fit of output tokens on
+# findings per request over this model and output mode, applied to the
+# history's findings density. Latency: a fit of milliseconds on output
+# tokens, evaluated with the thinking reserve for effort $4. Under three
+# checks the EST_DEFAULTS apply.
+_estimate() {
+  local -i lines=$1 bytes=$2 calls=$3 reserve
+  local -- hist
+  hist=$(_runs_log)
+  [[ -f $hist ]] || hist=/dev/null
+  reserve=$(_thinking_budget "$backend" "$model" "$4")
+  local -- base=${EST_DEFAULTS[out_base]} per=${EST_DEFAULTS[out_finding]}
+  ((!json_output)) || base=${EST_DEFAULTS[json_out_base]} per=${EST_DEFAULTS[json_out_finding]}
+  read -ra est < <(awk -v be="$backend" -v mo="$model" -v js="$json_output" \
+      -v lines="$lines" -v bytes="$bytes" -v calls="$calls" -v reserve="$reserve" \
+      -v dratio="${EST_DEFAULTS[bytes_per_token]}" -v ddens="${EST_DEFAULTS[findings_per_line]}" \
+      -v dbase="$base" -v dper="$per" '
+    # Fields of the records _run_record writes (fixed layout, no nesting
+    # beyond one level, so a key match is unambiguous)
+    function num(k) {
+      return match($0, "\"" k "\":[0-9]+") ? substr($0, RSTART + length(k) + 3, RLENGTH - length(k) - 3) + 0 : 0
+    }
+    function str(k) {
+      return match($0, "\"" k "\":\"[^\"]*\"") ? substr($0, RSTART + length(k) + 4, RLENGTH - length(k) - 5) : ""
+    }
+    !/"prompt_bytes":[1-9]/ { next }
+    {
+      if (str("backend") != be) next
+      rq = num("requests"); pb = num("prompt_bytes"); ti = num("in"); to = num("out")
+      if (rq <= 0 || ti <= 0) next
+      bb += pb; bi += ti
+      if (str("model") != mo) next
+      mb += pb; mi += ti
+      if (/"json":true/ == js) {
+        fd = num("error") + num("warning")
+        n++; x = fd / rq; y = to / rq
+        sx += x; sy += y; sxx += x * x; sxy += x * y; fl += fd; ll += num("lines")
+      }
+      if ((ms = num("llm_ms")) > 0) {
+        m++; u = to / rq; v = ms / rq
+        su += u; sv += v; suu += u * u; suv += u * v
+      }
+    }
+    END {
+      ratio = mi > 0 ? mb / mi : (bi > 0 ? bb / bi : dratio)
+      if (n >= 3) {
+        dens = ll > 0 ? fl / ll : ddens
+        den = n * sxx - sx * sx
+        b = den > 0 ? (n * sxy - sx * sy) / den : -1
+        if (b < 0) b = dper
+        a = (sy - b * sx) / n
+        if (a < 0) a = 0
+      } else {
+        n = 0; dens = ddens; a = dbase; b = dper
+      }
+      f = dens * lines / calls
+      out = a + b * f
+      lat = -1; rate = 0
+      if (m >= 1 && su > 0) {
+        den = m * suu - su * su
+        d = den > 0 ? (m * suv - su * sv) / den : -1
+        if (d <= 0) { d = sv / su; c = 0 } else c = (sv - d * su) / m
+        if (c < 0) c = 0
+        lat = c + d * (out + reserve)
+        rate = 1000 / d
+      }
+      printf "%d %d %.1f %d %.2f %d %d %d\n", bytes / ratio, out + 0.5, f * calls, lat, ratio, n, m, rate
+    }' "$hist")
+  ((${#est[@]} == 8))
+}
+
+# Lowest effort, from $2 up, whose max_tokens holds $1 output tokens plus
+# its thinking reserve within the EST_DEFAULTS headroom; empty when none.
+_effort_fit() {
+  local -i out=$1 i reserve
+  local -- e
+  for ((i = $(_effort_index "$2"); i < ${#VALID_EFFORTS[@]}; i+=1)); do
+    e=${VALID_EFFORTS[i]}
+    reserve=$(_thinking_budget "$backend" "$model" "$e")
+    (( (out + reserve) * 100 <= EFFORT_TOKENS[$e] * EST_DEFAULTS[headroom] )) || continue
+    echo "$e"
+    return 0
+  done
+}
+
+# Position of effort $1 in VALID_EFFORTS.
+_effort_index() {
+  local -i i
+  for ((i = 0; i < ${#VALID_EFFORTS[@]}; i+=1)); do
+    [[ ${VALID_EFFORTS[i]} != "$1" ]] || { echo "$i"; return 0; }
+  done
+  echo 0
+}
+
+# --estimate: print the forecast for one check instead of making it --
+# tokens in and out against max_tokens, expected latency, and whether the
+# answer is likely to be cut off, with the lowest effort that fits.
+# Reads _check_file's script_file, est_lines, est_calls and prompt_bytes.
+_estimate_report() {
+  local -a est=()
+  _estimate "$est_lines" "$prompt_bytes" "$est_calls" "$effort" \
+    || die 1 "Failed to estimate ${script_file@Q}"
+  local -i max=${EFFORT_TOKENS[$effort]} reserve need truncation=0
+  local -- fit
+  reserve=$(_thinking_budget "$backend" "$model" "$effort")
+  need=$((est[1] + reserve))
+  fit=$(_effort_fit "${est[1]}" "$effort")
+  [[ $fit == "$effort" ]] || truncation=1
+  [[ $fit != "$effort" ]] || fit=''
+  if ((json_output)); then
+    jq -n --arg file "$script_file" --arg backend "$backend" --arg model "$model" \
+      --arg effort "$effort" --argjson calls "$est_calls" --argjson lines "$est_lines" \
+      --argjson prompt_bytes "$prompt_bytes" --argjson in "${est[0]}" --argjson out "$need" \
+      --argjson thinking "$reserve" --argjson max "$max" --argjson findings "${est[2]}" \
+      --argjson latency "${est[3]}" --argjson ratio "${est[4]}" --argjson rate "${est[7]}" \
+      --argjson fitted "${est[5]}" --argjson timed "${est[6]}" \
+      --argjson truncation "$truncation" --arg suggest "$fit" \
+      '{source: "bcs", estimate: {file: $file, backend: $backend, model: $model, effort: $effort,
+        requests: $calls, lines: $lines, prompt_bytes: $prompt_bytes, bytes_per_token: $ratio,
+        input_tokens: $in, output_tokens: $out, thinking_tokens: $thinking, max_tokens: $max,
+        findings: $findings,
+        latency_ms: (if $latency < 0 then null else $latency end),
+        output_tokens_per_second: (if $latency < 0 then null else $rate end),
+        truncation_likely: ($truncation == 1),
+        suggested_effort: (if $suggest == "" then null else $suggest end),
+        history: {output: $fitted, latency: $timed}}}'
+    return 0
+  fi
+  local -- calib='defaults' per_call='' plural=s
+  ((!est[5])) || calib="calibrated from ${est[5]} checks"
+  ((est_calls == 1)) && plural='' || per_call=' per request'
+  printf 'Estimate: %s\n' "$script_file"
+  printf '  Backend:    %s %s (effort %s, %d request%s)\n' "$backend" "$model" "$effort" \
+    "$est_calls" "$plural"
+  printf '  Input:      ~%d tokens (%s prompt at %s bytes/token)\n' "${est[0]}" \
+    "$(_human_size "$prompt_bytes")" "${est[4]}"
+  printf '  Output:     ~%d tokens%s of %d max (~%s findings; %s)\n' "$need" "$per_call" \
+    "$max" "${est[2]}" "$calib"
+  if ((est[3] >= 0)); then
+    printf '  Latency:    ~%d.%ds%s (%d output tokens/s over %d checks)\n' $((est[3] / 1000)) \
+      $((est[3] % 1000 / 100)) "$per_call" "${est[7]}" "${est[6]}"
+  else
+    printf '  Latency:    unknown (no history for %s)\n' "$model"
+  fi
+  if ((!truncation)); then
+    printf '  Truncation: unlikely\n'
+  elif [[ -n $fit ]]; then
+    printf '  Truncation: likely -- use -e %s (%d max tokens) or --auto-effort\n' \
+      "$fit" "${EFFORT_TOKENS[$fit]}"
+  else
+    printf '  Truncation: likely even at -e max -- lower --chunk-lines\n'
+  fi
+}
+#fin
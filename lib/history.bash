@@ -0,0 +1,199 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# lib/history.bash - bcs module. Run history: the per-file record every
+# check appends to runs.ndjson, and bcs stats, which summarises it.
+# Sourced by bcs on first use (_bcs_module): functions only, reading and
+# setting bcs's globals and their callers' locals (hence SC2034/SC2154).
+#shellcheck shell=bash disable=SC2034,SC2154
+
+# ---- Run history (bcs stats) ----
+
+# Set the caller's quoted to $1 escaped for a JSON string (backslash,
+# quote, newline, tab, carriage return; other control bytes do not occur
+# in the paths and model names recorded).
+_json_quote() {
+  quoted=${1//\\/\\\\}
+  quoted=${quoted//\"/\\\"}
+  quoted=${quoted//$'\n'/\\n}
+  quoted=${quoted//$'\t'/\\t}
+  quoted=${quoted//$'\r'/\\r}
+}
+
+# Append the run record for the script being checked: exit status $1,
+# EPOCHREALTIME stamp $2 of the file's start, token line $3, model
+# milliseconds $4 and, for a live API review that calibrates _estimate,
+# prompt bytes $5 (else 0), to cmd_check's runs_log. Reads the caller's
+# backend, model and output, the est_* sizes when _check_file measured
+# them, and the phase spans in BCS_TIMINGS_FILE. Built with builtins (the
+# script hash comes from the cache key when there is one), so a record
+# costs no jq. Appends hold a shared flock on runs_log.lock; now and then
+# one trims the log to the last 5000 records under the exclusive lock, so
+# no append can land in a copy that is about to replace the log.
+_run_record() {
+  local -- tokens=${3:-} kv log=$runs_log sum='' phases='' phase text rest quoted mark line
+  local -- is_json=false is_hit=false
+  local -i rc=$1 llm_ms=${4:-0} prompt=${5:-0} tok_in=0 tok_out=0 ms n_error=0 n_warning=0 n span_ms
+  local -i lines=${est_lines:-0} bytes=${est_bytes:-0} calls=${est_calls:-1}
+  ms=$(( (${EPOCHREALTIME/[.,]/} - ${2/[.,]/}) / 1000 ))
+  for kv in $tokens; do
+    case $kv in
+      in=*|cache_creation=*|cache_read=*) tok_in+=${kv#*=} ;;
+      out=*) tok_out=${kv#*=} ;;
+      *)     : ;;
+    esac
+  done
+  [[ -n ${est_lines:-} ]] || read -r lines bytes < <(wc -lc < "$script_file")
+  # The cache key's hash of the script, else one of its own
+  sum=${script_sum:-}
+  [[ -n $sum ]] || { sum=$(sha256sum < "$script_file" 2>/dev/null) ||:; sum=${sum%% *}; }
+
+  # Phase spans summed per phase, in first-seen order (as _timings_summary)
+  if [[ -s ${BCS_TIMINGS_FILE:-} ]]; then
+    local -A span=()
+    local -a order=()
+    while read -r phase span_ms; do
+      [[ -v span[$phase] ]] || order+=("$phase")
+      span[$phase]=$(( ${span[$phase]:-0} + span_ms ))
+    done < "$BCS_TIMINGS_FILE"
+    for phase in "${order[@]}"; do phases+=",\"$phase\":${span[$phase]}"; done
+    phases=${phases#,}
+  fi
+
+  # Findings by level: the rendered envelope in JSON mode, else the static
+  # rows and the text report's finding headers -- keyed as _merge_text keys
+  # them, since the summary table repeats every severity
+  if ((json_output)); then
+    text=${json_doc:-}
+  else
+    text=${static_rows:-}
+    while IFS= read -r line; do
+      [[ $line =~ \[(ERROR|WARN)\]\ BCS[0-9]+\ line\ [0-9]+ ]] || continue
+      if [[ ${BASH_REMATCH[1]} == ERROR ]]; then n_error+=1; else n_warning+=1; fi
+    done <<< "${result:-}"
+  fi
+  for mark in '"level": "error"' $'\terror\t'; do
+    rest=${text//"$mark"/}
+    n_error+=$(( (${#text} - ${#rest}) / ${#mark} ))
+  done
+  for mark in '"level": "warning"' $'\twarning\t'; do
+    rest=${text//"$mark"/}
+    n_warning+=$(( (${#text} - ${#rest}) / ${#mark} ))
+  done
+
+  local -- q_file q_model
+  _json_quote "$script_file"; q_file=$quoted
+  _json_quote "$model"; q_model=$quoted
+  ((!json_output)) || is_json=true
+  ((!${cache_hit:-0})) || is_hit=true
+  local -i lock=-1
+  if command -v flock &>/dev/null && exec {lock}>> "$log".lock; then
+    flock -s "$lock" ||:
+  fi 2>/dev/null
+  printf '{"ts":%d,"file":"%s","sha256":"%s","backend":"%s","model":"%s","effort":"%s","engine":"%s","json":%s,"cache":%s,"lines":%d,"bytes":%d,"requests":%d,"prompt_bytes":%d,"tokens":{"in":%d,"out":%d},"ms":%d,"llm_ms":%d,"phases":{%s},"findings":{"error":%d,"warning":%d},"exit":%d}\n' \
+    "$EPOCHSECONDS" "$q_file" "$sum" "$backend" "$q_model" "$effort" "$engine" \
+    "$is_json" "$is_hit" \
+    "$lines" "$bytes" "$calls" "$prompt" "$tok_in" "$tok_out" "$ms" "$llm_ms" "$phases" \
+    "$n_error" "$n_warning" "$rc" >> "$log" 2>/dev/null ||:
+  # Trim only under the exclusive lock (never without flock): upgrading
+  # fails while another append holds its shared lock, and then the next
+  # record tries again
+  if ((lock >= 0 && RANDOM % 50 == 0)) && flock -xn "$lock" 2>/dev/null; then
+    n=$(wc -l < "$log")
+    ((n <= 5000)) || { tail -n 5000 -- "$log" > "$log.$BASHPID" && mv -f -- "$log.$BASHPID" "$log"; } 2>/dev/null ||:
+  fi
+  ((lock < 0)) || exec {lock}>&-
+}
+
+# Subcommand: stats
+
+cmd_stats() {
+  local -- model_glob='' days=''
+  local -i json_mode=0
+
+  while (($#)); do case $1 in
+    -d|--days)       noarg "$@"; shift; days=$1
+                     [[ $days =~ ^[1-9][0-9]*$ ]] || die 22 "Invalid day count ${days@Q}"
+                     ;;
+    -m|--model)      noarg "$@"; shift; model_glob=$1 ;;
+    -j|--json)       json_mode=1 ;;
+    -v|--verbose)    VERBOSE=1 ;;
+    -q|--quiet)      VERBOSE=0 ;;
+    -h|--help)       show_stats_help; return 0 ;;
+    -[dmjvqh]?*)     set -- "${1:0:2}" "-${1:2}" "${@:2}"; continue ;;
+    -*)              die 22 "Invalid option ${1@Q}" ;;
+    *)               die 2 "Unexpected argument ${1@Q}" ;;
+  esac; shift; done
+
+  local -- log
+  log=$(_runs_log)
+  [[ -s $log ]] || die 3 "No run history at ${log@Q} (run bcs check first)"
+
+  # The model filter is a glob; jq matches it as the equivalent regex
+  local -- model_re=''
+  if [[ -n $model_glob ]]; then
+    model_re=${model_glob//[.+^\$()|\{\}\[\]\\]/\\&}
+    model_re=${model_re//\*/.*}
+    model_re="^${model_re//\?/.}\$"
+  fi
+
+  # One pass: parse (skipping torn lines), filter, then group by backend,
+  # model and effort. Percentiles are nearest-rank.
+  local -- doc
+  doc=$(jq -Rn --argjson since "$(( days ? EPOCHSECONDS - days * 86400 : 0 ))" \
+          --arg model_re "$model_re" '
+    def pct($p): sort | if length == 0 then null else .[(length * $p | ceil) - 1] end;
+    def avg: if length == 0 then null else add / length | round end;
+    def rate($a; $b): if $b > 0 then ($a / $b * 1000 | round) / 1000 else null end;
+    [inputs | try fromjson catch null | select(type == "object")]
+    | map(select(.ts >= $since and ($model_re == "" or (.model | test($model_re)))))
+    | {source: "bcs", stats: {
+        runs: length,
+        calls: map(select(.cache | not)) | length,
+        cache_hits: map(select(.cache)) | length,
+        first: (map(.ts) | min), last: (map(.ts) | max),
+        models: (group_by([.backend, .model, .effort]) | map(
+          . as $runs | map(select(.cache | not)) as $calls
+          | ($calls | map(select(.llm_ms > 0 and .tokens.out > 0))) as $timed
+          | {backend: .[0].backend, model: .[0].model, effort: .[0].effort,
+             runs: length, calls: ($calls | length),
+             cache_hit_rate: rate(map(select(.cache)) | length; length),
+             latency_ms: {p50: ($calls | map(.ms) | pct(0.5)),
+                          p95: ($calls | map(.ms) | pct(0.95))},
+             output_tokens_per_second:
+               (if ($timed | length) == 0 then null
+                else ($timed | map(.tokens.out) | add) * 1000 / ($timed | map(.llm_ms) | add) | . * 10 | round / 10 end),
+             tokens: {in: ($calls | map(select(.tokens.in > 0) | .tokens.in) | avg),
+                      out: ($calls | map(select(.tokens.out > 0) | .tokens.out) | avg)},
+             findings_per_kloc: (($calls | if length == 0 then $runs else . end) as $c
+               | ($c | map(.lines) | add) as $l
+               | if $l > 0 then ($c | map(.findings.error + .findings.warning) | add) * 1000 / $l
+                                | . * 10 | round / 10 else null end),
+             failures: map(select(.exit > 1)) | length})
+          | sort_by(.latency_ms.p50 // infinite))}}' < "$log") \
+    || die 5 "Failed to read run history ${log@Q}"
+
+  if ((json_mode)); then
+    echo "$doc"
+    return 0
+  fi
+  local -- rows
+  rows=$(jq -r '.stats as $s
+    | "Runs: \($s.runs) (\($s.calls) calls, \($s.cache_hits) cache hits)"
+      + (if $s.runs > 0 then ", \($s.first | strftime("%Y-%m-%d")) to \($s.last | strftime("%Y-%m-%d"))" else "" end),
+      ($s.models[] | [.backend, .model, .effort, .runs, ((.cache_hit_rate // 0) * 100 | round),
+                      .latency_ms.p50, .latency_ms.p95, .output_tokens_per_second,
+                      .tokens.in, .tokens.out, .findings_per_kloc, .failures]
+       | map(. // "-" | tostring) | join("\t"))' <<< "$doc")
+  local -- line backend model effort runs hit p50 p95 tps tin tout kloc fail
+  {
+    IFS= read -r line
+    echo "$line"
+    printf '%-10s %-26s %-7s %5s %4s %7s %7s %6s %7s %6s %6s %4s\n' \
+      Backend Model Effort Runs Hit% p50 p95 Tok/s In Out /KLOC Fail
+    while IFS=$'\t' read -r backend model effort runs hit p50 p95 tps tin tout kloc fail; do
+      printf '%-10s %-26s %-7s %5s %4s %7s %7s %6s %7s %6s %6s %4s\n' \
+        "$backend" "$model" "$effort" "$runs" "$hit" "$p50" "$p95" "$tps" "$tin" "$tout" "$kloc" "$fail"
+    done
+  } <<< "$rows"
+}
+#fin
@@ -0,0 +1,246 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# lib/serve.bash - bcs module. The bcs serve daemon and its client: a warm
+# bcs on a Unix socket that runs check and codes requests for bcs --client.
+# Sourced by bcs on first use (_bcs_module): functions only, reading and
+# setting bcs's globals and their callers' locals (hence SC2034/SC2154).
+#shellcheck shell=bash disable=SC2034,SC2154
+
+# ---- Daemon transport (bcs serve) ----
+
+# Socket a `bcs serve` daemon listens on and `bcs --client` talks to.
+_serve_socket() {
+  printf '%s\n' "${BCS_SOCKET:-${XDG_RUNTIME_DIR:-$(_state_root)}/bcs.sock}"
+}
+
+# Send command $1 (arguments $2...) to the daemon on BCS_SOCKET and replay
+# its stdout, stderr and exit status. Returns 111 (ECONNREFUSED) without
+# output when no daemon answers. Bash cannot open Unix sockets, so the
+# exchange rides on python3.
+_serve_client() {
+  command -v python3 &>/dev/null || return 111
+  python3 -c '
+import json, os, socket, sys
+try:
+    s = socket.socket(socket.AF_UNIX)
+    s.connect(sys.argv[1])
+    s.sendall(json.dumps({"id": 1, "cmd": sys.argv[2], "cwd": os.getcwd(),
+                          "args": sys.argv[3:]}).encode() + b"\n")
+    r = json.loads(s.makefile("rb").readline())
+except (OSError, ValueError):
+    sys.exit(111)
+sys.stdout.buffer.write(r["stdout"].encode("utf-8", "surrogateescape"))
+sys.stderr.buffer.write(r["stderr"].encode("utf-8", "surrogateescape"))
+sys.exit(r["exit"])' "$BCS_SOCKET" "$@"
+}
+
+# Start the socket listener for run directory $1 in the background and set
+# the caller's `listener` to its pid. The listener owns the JSON side: per
+# request line it writes the NUL-separated cmd, cwd and args to $1/N, makes
+# the reply FIFO $1/N.out and queues "N" on $1/req for the daemon loop. The
+# daemon answers on the FIFO with "EXIT COALESCED\n", stdout, NUL, stderr.
+_serve_listen() {
+  python3 - "$BCS_SOCKET" "$1" <<'PY' &
+import itertools, json, os, socket, sys, threading
+path, run = sys.argv[1:3]
+seq, lock = itertools.count(1), threading.Lock()
+def answer(req):
+    if not isinstance(req, dict) or not isinstance(req.get('args', []), list):
+        return {'exit': 22, 'stdout': '', 'stderr': 'bcs serve: malformed request\n'}
+    n = str(next(seq))
+    fields = [req.get('cmd'), req.get('cwd') or '/'] + req.get('args', [])
+    with open(os.path.join(run, n), 'wb') as f:
+        f.write(b''.join(str(x).encode('utf-8', 'surrogateescape') + b'\0' for x in fields))
+    os.mkfifo(os.path.join(run, n + '.out'), 0o600)
+    with lock, open(os.path.join(run, 'req'), 'w') as q:
+        q.write(n + '\n')
+    with open(os.path.join(run, n + '.out'), 'rb') as f:
+        head, _, body = f.read().partition(b'\n')
+    for p in (n, n + '.out'):
+        os.unlink(os.path.join(run, p))
+    rc, dup = head.split()
+    out, _, err = body.decode('utf-8', 'surrogateescape').partition('\0')
+    return dict({'exit': int(rc), 'stdout': out, 'stderr': err}, **({'coalesced': True} if dup == b'1' else {}))
+def serve(conn):
+    with conn, conn.makefile('rb') as lines:
+        for line in lines:
+            try:
+                req = json.loads(line)
+            except ValueError:
+                req = None
+            reply = answer(req)
+            if isinstance(req, dict) and 'id' in req:
+                reply = {'id': req['id'], **reply}
+            try:
+                conn.sendall(json.dumps(reply).encode() + b'\n')
+            except OSError:
+                return
+if os.path.exists(path):
+    os.unlink(path)
+srv = socket.socket(socket.AF_UNIX)
+os.umask(0o177)
+srv.bind(path)
+srv.listen(64)
+while True:
+    threading.Thread(target=serve, args=(srv.accept()[0],), daemon=True).start()
+PY
+  listener=$!
+}
+
+# Answer reply FIFO $1: exit status $2, coalesced flag $3, stdout file $4,
+# stderr file $5 (or text $4/$5 with no such files).
+_serve_answer() {
+  {
+    printf '%d %d\n' "$2" "$3"
+    if [[ -f $4 ]]; then cat -- "$4"; else printf '%s' "$4"; fi
+    printf '\0'
+    if [[ -f ${5:-} ]]; then cat -- "$5"; else printf '%s' "${5:-}"; fi
+  } > "$1" ||:
+}
+
+# Run request $2 (command $3 in directory $4, arguments $5...) in a fork of
+# the warmed daemon with output in $1/N.stdout and $1/N.stderr, then post
+# "done N EXIT" to the daemon loop.
+_serve_run() {
+  local -- run=$1 n=$2 cmd=$3 cwd=$4
+  shift 4
+  local -i rc=0
+  (
+    _TMP_CLEANUP=()
+    trap _cleanup_tmps EXIT
+    VERBOSE=1 READ_CONF_MS=0
+    cd -- "$cwd" || die 3 "No such directory ${cwd@Q}"
+    # A project policy applies only to requests from inside that project
+    [[ ! -f .bcs/policy.conf ]] || { BCS_POLICY=(); _POLICY_LOADED=0; }
+    case $cmd in
+      check)   cmd_check "$@" ;;
+      codes)   cmd_codes "$@" ;;
+      explain) cmd_codes -E "${1:-}" ;;
+    esac
+  ) < /dev/null > "$run/$n".stdout 2> "$run/$n".stderr || rc=$?
+  printf 'done %s %d\n' "$n" "$rc" > "$run"/req
+}
+
+# Hand request $2's finished output (exit $3) to every reply FIFO in $4, one
+# per line; all but the first are marked coalesced.
+_serve_reply() {
+  local -- fifo
+  local -i dup=0
+  while IFS= read -r fifo; do
+    _serve_answer "$fifo" "$3" "$dup" "$1/$2".stdout "$1/$2".stderr
+    dup=1
+  done <<< "$4"
+  rm -f -- "$1/$2".stdout "$1/$2".stderr
+}
+
+# Subcommand: serve
+
+cmd_serve() {
+  local -- sock='' action=serve
+
+  while (($#)); do case $1 in
+    -s|--socket)     noarg "$@"; shift; sock=$1 ;;
+    --status)        action=ping ;;
+    --stop)          action=shutdown ;;
+    -v|--verbose)    VERBOSE=1 ;;
+    -q|--quiet)      VERBOSE=0 ;;
+    -h|--help)       show_serve_help; return 0 ;;
+    -[svqh]?*)       set -- "${1:0:2}" "-${1:2}" "${@:2}"; continue ;;
+    -*)              die 22 "Invalid option ${1@Q}" ;;
+    *)               die 2 "Unexpected argument ${1@Q}" ;;
+  esac; shift; done
+
+  local -x BCS_SOCKET=${sock:-$(_serve_socket)}
+  local -i rc=0
+  if [[ $action != serve ]]; then
+    _serve_client "$action" || rc=$?
+    ((rc != 111)) || die 1 "No bcs serve on ${BCS_SOCKET@Q}"
+    return "$rc"
+  fi
+
+  command -v python3 &>/dev/null || die 18 'bcs serve needs python3 to listen on a Unix socket'
+  { _serve_client ping &>/dev/null || rc=$?; ((rc == 111)); } \
+    || die 1 "Already serving on ${BCS_SOCKET@Q}"
+  # Colours were chosen from the terminal at startup, but worker output goes
+  # to clients: come back up with stdout off the terminal.
+  [[ -z $NC ]] || exec "$SCRIPT_PATH" serve -s "$BCS_SOCKET" "$( ((VERBOSE)) && echo -v || echo -q)" >/dev/null
+
+  # Warm everything a request would otherwise load: the standard, the tier
+  # and detector maps, system/user policy and the run-history module.
+  # Workers fork from here.
+  cd /
+  _find_bcs_md >/dev/null || die 3 'BASH-CODING-STANDARD.md not found'
+  _load_tiers
+  _load_policy
+  _bcs_module history
+
+  local -- run listener
+  run=$(mktemp -d "${TMPDIR:-/tmp}"/bcs-serve.XXXXXX) || die 1 'mktemp failed'
+  _register_tmp "$run"
+  mkfifo -m 600 "$run"/req
+  local -i q i
+  exec {q}<>"$run"/req
+  mkdir -p -- "${BCS_SOCKET%/*}"
+  _serve_listen "$run"
+  _register_tmp "$BCS_SOCKET"
+  #shellcheck disable=SC2064  # the pid is fixed now
+  trap "kill $listener 2>/dev/null; _cleanup_tmps" EXIT
+  for ((i = 0; i < 100; i+=1)); do [[ ! -S $BCS_SOCKET ]] || break; _sleep_ms 50; done
+  [[ -S $BCS_SOCKET ]] || die 1 "Listener failed on ${BCS_SOCKET@Q}"
+  success "Serving on $BCS_SOCKET (pid $$)"
+
+  # In-flight requests are keyed by a sha256 of command, directory,
+  # arguments and the size/mtime of any file arguments -- hex, so no path
+  # can upset an array subscript; a duplicate joins the running request as
+  # another reply FIFO instead of starting a second review.
+  local -A slot=() keyof=() waiters=()
+  local -a f=()
+  local -- msg n key arg path
+  local -i dead=0
+  while :; do
+    # The queue FIFO is held open read-write, so a dead listener would
+    # leave this read blocked forever: poll its pid between requests.
+    if ! IFS= read -r -t 1 -u "$q" msg; then
+      kill -0 "$listener" 2>/dev/null && continue
+      error "Listener on ${BCS_SOCKET@Q} exited; stopping"
+      dead=1
+      break
+    fi
+    if [[ $msg == done\ * ]]; then
+      read -r _ n rc <<< "$msg"
+      _serve_reply "$run" "$n" "$rc" "${waiters[$n]}" &
+      key=${keyof[$n]}
+      unset -v 'slot[$key]' 'keyof[$n]' 'waiters[$n]'
+      continue
+    fi
+    n=$msg
+    readarray -d '' -t f < "$run/$n"
+    case ${f[0]} in
+      ping)     _serve_answer "$run/$n".out 0 0 "bcs $VERSION serving on $BCS_SOCKET (pid $$)"$'\n' & continue ;;
+      shutdown) _serve_answer "$run/$n".out 0 0 ''; break ;;
+      check|codes|explain) ;;
+      *)        _serve_answer "$run/$n".out 2 0 '' "bcs serve: unknown command ${f[0]@Q}"$'\n' & continue ;;
+    esac
+    key=${f[0]}$'\t'${f[1]}
+    for arg in "${f[@]:2}"; do
+      key+=$'\t'$arg
+      [[ $arg == /* ]] && path=$arg || path=${f[1]}/$arg
+      [[ ! -f $path ]] || key+=" $(stat -c '%s %Y' -- "$path")"
+    done
+    key=$(sha256sum <<< "$key") key=${key%% *}
+    if [[ -n ${slot[$key]:-} ]]; then
+      waiters[${slot[$key]}]+=$'\n'$run/$n.out
+      info "#${slot[$key]}: coalesced ${f[0]} ${f[*]:2}"
+      continue
+    fi
+    slot[$key]=$n keyof[$n]=$key waiters[$n]=$run/$n.out
+    info "#$n: ${f[0]} ${f[*]:2}"
+    _serve_run "$run" "$n" "${f[@]}" &
+  done
+  # Give the listener a moment to pass on the shutdown reply
+  rm -f -- "$BCS_SOCKET"
+  ((!dead)) || return 1
+  _sleep_ms 200
+  success 'bcs serve stopped'
+}
+#fin
@@ -223,7 +223,7 @@ main() {
     info "run $run/$RUNS ..."
     for f in "${corpus[@]}"; do
       json=$(timeout "$TIMEOUT_S" "$BCS_CMD" check -j -m "$MODEL" -e "$EFFORT" \
-        --quiet -- "$f" 2>/dev/null) || true
+        --quiet --no-cache -- "$f" 2>/dev/null) || true
       if [[ -z $json ]] || ! jq -e 'has("comments")' <<<"$json" &>/dev/null; then
         INCONCLUSIVE+=1
         warn "inconclusive: ${f##*/} (run $run) — empty/invalid backend output"
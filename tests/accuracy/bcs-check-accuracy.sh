@@ -80,13 +80,13 @@ for script in "${BASH_SCRIPTS[@]}"; do
     modelname=${model//[:\/]/-}
     for effort in "${EFFORTS[@]}"; do
       output_to="$SCRIPT_DIR"/bcs-check_"$scriptname"_"$modelname"_"$effort".md
-      >&2 echo "bcs check --model $model --effort $effort ${script@Q} &>${output_to@Q}"
+      >&2 echo "bcs check --no-cache --model $model --effort $effort ${script@Q} &>${output_to@Q}"
       if [[ -f $output_to ]]; then
         >&2 echo "    ${output_to@Q} already exists; skipping"
         continue
       fi
 
-      bcs check --model "$model" --effort "$effort" "$script" &>"$output_to" ||:
+      bcs check --no-cache --model "$model" --effort "$effort" "$script" &>"$output_to" ||:
 
     done
   done
@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+# bcs-fixture-expect:
+# bcs-fixture-description: Fully BCS-compliant; quoted text and a path guard only look like `[ ]`, eval and /tmp paths; any finding is a false positive.
+set -euo pipefail
+shopt -s inherit_errexit shift_verbose extglob nullglob
+
+declare -r VERSION='1.0.0'
+declare -r TRACE_GLOB="/tmp/trace-*"
+
+describe() {
+  echo "- [ ] Todo item"
+  echo "This helper never uses eval for dispatch"
+  printf 'Trace files: %s\n' "$TRACE_GLOB"
+}
+
+main() {
+  if [[ ${1:-} == --version ]]; then
+    printf '%s\n' "$VERSION"
+    return 0
+  fi
+  local -- root=${1:-$PWD}
+  if [[ $root == /tmp/* ]]; then
+    printf 'refusing scratch root: %s\n' "$root" >&2
+    return 1
+  fi
+  describe
+}
+
+main "$@"
+#fin
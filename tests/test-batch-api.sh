@@ -0,0 +1,186 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-batch-api.sh - Provider batch jobs (bcs check --batch-submit /
+# --batch-collect) against the local HTTP stand-in, playing the Anthropic
+# Message Batches and OpenAI Batch endpoints one scripted reply at a time.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: batch API'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping - python3 not available)'
+  print_summary 'batch-api'
+  exit
+fi
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+printf '#!/bin/bash\necho there\n' > "$work"/t.sh
+s_id=$(bash -c 'source "$1"; _bcs_module batch; _batch_id "$2"' _ "$BCS_CMD" "$work"/s.sh)
+t_id=$(bash -c 'source "$1"; _bcs_module batch; _batch_id "$2"' _ "$BCS_CMD" "$work"/t.sh)
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+    OPENAI_BASE_URL="$STANDIN_URL" OPENAI_API_KEY=test-key BCS_RETRY_BASE_MS=20 "$@"
+}
+reset_standin() { rm -f "$work"/req.* "$work"/response.* "$work"/status*; }
+
+# ---------------------------------------------------------------------
+# Anthropic Message Batches
+# ---------------------------------------------------------------------
+begin_test 'submit packs every script into one Message Batches request'
+echo '{"id":"msgbatch_01","type":"message_batch","processing_status":"in_progress"}' \
+  > "$work"/response.1.json
+declare -i rc=0
+out=$(run_check -j -m claude-haiku-4-5 --batch-submit "$work"/s.sh "$work"/t.sh 2>/dev/null) || rc=$?
+assert_equal 0:msgbatch_01 "$rc:$out" 'prints the batch id' || true
+assert_contains "$(head -1 "$work"/req.1.head)" 'POST /v1/messages/batches' 'batches endpoint' || true
+assert_equal "$(printf '%s\n' "$s_id" "$t_id" | sort)" \
+  "$(jq -r '.requests[].custom_id' "$work"/req.1.json | sort)" 'one request per script' || true
+assert_equal claude-haiku-4-5 "$(jq -r '.requests[0].params.model' "$work"/req.1.json)" \
+  'params are the Messages payload' || true
+assert_equal 1 "$(ls "$work"/req.*.json | wc -l)" 'no per-script calls' || true
+state="$work"/state/bcs/batches/msgbatch_01.json
+assert_equal 'anthropic true 2' "$(jq -r '"\(.backend) \(.json) \(.files | length)"' "$state")" \
+  'job recorded under XDG_STATE_HOME' || true
+
+begin_test 'collect reports a job still in progress'
+reset_standin
+echo '{"id":"msgbatch_01","processing_status":"in_progress","request_counts":{"processing":2}}' \
+  > "$work"/response.1.json
+rc=0
+err=$(run_check --batch-collect msgbatch_01 2>&1 >/dev/null) || rc=$?
+assert_equal 11 "$rc" 'exit 11 (try again later)' || true
+assert_contains "$err" '2 processing' 'request counts shown' || true
+
+begin_test 'collect renders each result through the JSON envelope'
+reset_standin
+jq -nc --arg url "$STANDIN_URL/results" '{id: "msgbatch_01", processing_status: "ended", results_url: $url}' \
+  > "$work"/response.1.json
+{
+  jq -nc --arg id "$s_id" '{custom_id: $id, result: {type: "succeeded", message: {
+           content: [{type: "text", text: "[{\"line\":2,\"level\":\"error\",\"bcsCode\":\"BCS0101\",\"message\":\"x\"}]"}],
+           usage: {input_tokens: 40, output_tokens: 9}}}}'
+  jq -nc --arg id "$t_id" '{custom_id: $id, result: {type: "succeeded", message: {
+           content: [{type: "text", text: "[]"}], usage: {input_tokens: 30, output_tokens: 1}}}}'
+} > "$work"/response.2.json
+rc=0
+out=$(run_check --batch-collect msgbatch_01 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'exit 1: an error finding' || true
+assert_equal "$work/s.sh:BCS0101 $work/t.sh:" \
+  "$(jq -sr 'map("\(.meta.file):\(.comments | map(.bcsCode) | join(","))") | join(" ")' <<< "$out")" \
+  'one envelope per file, in order' || true
+assert_equal 'anthropic 9' "$(jq -sr '.[0] | "\(.meta.backend) \(.meta.tokens.out)"' <<< "$out")" \
+  'backend and batch usage in meta' || true
+assert_contains "$(head -1 "$work"/req.2.head)" 'GET /results' 'results fetched from results_url' || true
+assert_gt "$(jq -r '.collected | length' "$state")" 0 'job marked collected' || true
+
+begin_test 'a failed request fails only its file'
+reset_standin
+rm -rf "$work"/cache   # the first collect cached both reviews
+jq -nc --arg url "$STANDIN_URL/results" '{processing_status: "ended", results_url: $url}' \
+  > "$work"/response.1.json
+{
+  jq -nc --arg id "$s_id" '{custom_id: $id, result: {type: "errored",
+           error: {type: "error", error: {type: "overloaded_error", message: "Overloaded"}}}}'
+  jq -nc --arg id "$t_id" '{custom_id: $id, result: {type: "succeeded", message: {
+           content: [{type: "text", text: "[]"}], usage: {input_tokens: 30, output_tokens: 1}}}}'
+} > "$work"/response.2.json
+rc=0
+out=$(run_check --batch-collect msgbatch_01 2>"$work"/err) || rc=$?
+assert_equal 5 "$rc" 'exit 5' || true
+assert_contains "$(< "$work"/err)" 'Overloaded' 'provider error shown' || true
+assert_equal "$work/s.sh:0 $work/t.sh:0" \
+  "$(jq -sr 'map("\(.meta.file):\(.comments | length)") | join(" ")' <<< "$out")" \
+  'other file still rendered' || true
+
+begin_test 'a script edited since submission is refused, not replayed'
+reset_standin
+rm -rf "$work"/cache
+jq -nc --arg url "$STANDIN_URL/results" '{processing_status: "ended", results_url: $url}' \
+  > "$work"/response.1.json
+{
+  jq -nc --arg id "$s_id" '{custom_id: $id, result: {type: "succeeded", message: {
+           content: [{type: "text", text: "[]"}], usage: {input_tokens: 30, output_tokens: 1}}}}'
+  jq -nc --arg id "$t_id" '{custom_id: $id, result: {type: "succeeded", message: {
+           content: [{type: "text", text: "[{\"line\":2,\"level\":\"error\",\"bcsCode\":\"BCS0101\",\"message\":\"x\"}]"}],
+           usage: {input_tokens: 30, output_tokens: 9}}}}'
+} > "$work"/response.2.json
+cp "$work"/t.sh "$work"/t.orig
+printf '#!/bin/bash
+
+echo there
+' > "$work"/t.sh
+rc=0
+out=$(run_check --batch-collect msgbatch_01 2>"$work"/err) || rc=$?
+assert_equal 3 "$rc" 'exit 3' || true
+assert_contains "$(< "$work"/err)" 't.sh'"'"' changed since batch msgbatch_01' 'edited file named' || true
+assert_equal "$work/s.sh" "$(jq -r '.meta.file' <<< "$out")" 'only the unchanged file rendered' || true
+assert_equal 1 "$(find "$work"/cache -name '*.json' | wc -l)" 'stale answer not cached' || true
+mv -f "$work"/t.orig "$work"/t.sh
+
+begin_test 'submit refuses non-batch backends and unknown jobs'
+rc=0
+run_check -m claude-code --batch-submit "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'claude-code -> 22' || true
+rc=0
+run_check --engine static --batch-submit "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'static engine -> 22' || true
+rc=0
+run_check --batch-collect nope &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'unknown batch -> 3' || true
+
+begin_test 'submit with every file skipped has nothing to send'
+reset_standin
+mkdir -p "$work"/repo
+cp "$work"/s.sh "$work"/repo/
+git -C "$work"/repo init -q
+git -C "$work"/repo -c user.name=t -c user.email=t@t add s.sh
+git -C "$work"/repo -c user.name=t -c user.email=t@t commit -qm init
+rc=0
+err=$(run_check -m claude-haiku-4-5 --since HEAD --batch-submit "$work"/repo/s.sh 2>&1) || rc=$?
+assert_equal 5 "$rc" 'unchanged since HEAD -> 5' || true
+assert_contains "$err" 'No requests to submit' 'reported' || true
+assert_not_contains "$err" 'unbound variable' 'no crash' || true
+assert_equal 0 "$(find "$work" -maxdepth 1 -name 'req.*' | wc -l)" 'nothing sent' || true
+
+# ---------------------------------------------------------------------
+# OpenAI Batch
+# ---------------------------------------------------------------------
+begin_test 'OpenAI: upload a JSONL file, then create the batch'
+reset_standin
+echo '{"id":"file-in","purpose":"batch"}' > "$work"/response.1.json
+echo '{"id":"batch_9","status":"validating"}' > "$work"/response.2.json
+rc=0
+out=$(run_check -m gpt-5-mini --batch-submit "$work"/s.sh "$work"/t.sh 2>/dev/null) || rc=$?
+assert_equal 0:batch_9 "$rc:$out" 'batch id' || true
+assert_contains "$(cat "$work"/req.1.head)" 'multipart/form-data' 'file upload is multipart' || true
+assert_contains "$(< "$work"/req.1.json)" '"url":"/v1/chat/completions"' 'JSONL request lines' || true
+assert_equal 'file-in /v1/chat/completions' \
+  "$(jq -r '"\(.input_file_id) \(.endpoint)"' "$work"/req.2.json)" 'batch created from the upload' || true
+
+begin_test 'OpenAI: collect reads the output file'
+reset_standin
+echo '{"id":"batch_9","status":"completed","output_file_id":"file-out"}' > "$work"/response.1.json
+{
+  jq -nc --arg id "$s_id" '{custom_id: $id, response: {status_code: 200, body: {
+           choices: [{message: {content: "[WARN] BCS0702 line 2: s"}}],
+           usage: {prompt_tokens: 50, completion_tokens: 7}}}}'
+  jq -nc --arg id "$t_id" '{custom_id: $id, response: {status_code: 200, body: {
+           choices: [{message: {content: "[WARN] BCS0702 line 2: t"}}],
+           usage: {prompt_tokens: 50, completion_tokens: 7}}}}'
+} > "$work"/response.2.json
+rc=0
+out=$(run_check --batch-collect batch_9 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0 on warnings' || true
+assert_contains "$out" '[WARN] BCS0702 line 2: s' 'first file' || true
+assert_contains "$out" '[WARN] BCS0702 line 2: t' 'second file' || true
+assert_contains "$(head -1 "$work"/req.2.head)" 'GET /v1/files/file-out/content' 'output file fetched' || true
+
+print_summary 'batch-api'
+#fin
@@ -2,8 +2,10 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 # test-check-shellcheck.sh - Unit tests for shellcheck static-analysis context
 #
-# Verifies the _run_shellcheck and _render_shellcheck_block helpers and
-# that cmd_check's --shellcheck / --no-shellcheck flags parse cleanly.
+# Verifies the _run_shellcheck and _render_shellcheck_block helpers, the
+# source-aware report cache and the single background shellcheck pass of
+# a multi-file check, and that cmd_check's --shellcheck / --no-shellcheck
+# flags parse cleanly.
 #
 # NOTE: sourcing bcs marks PATH readonly (declare -rx PATH=... at bcs:9),
 # so we cannot test the "binary missing" path by manipulating PATH.
@@ -116,5 +118,109 @@ begin_test 'check help mentions BCS_SHELLCHECK env var'
 output=$("$BCS_CMD" check -h 2>/dev/null)
 assert_contains "$output" 'BCS_SHELLCHECK' 'help mentions BCS_SHELLCHECK'
 
+# --- Sources behind the cache key ------------------------------------------
+
+sc_home=$(mktemp -d)
+trap 'rm -rf "$sc_home"' EXIT
+mkdir -p "$sc_home"/.local/bin "$sc_home"/lib
+printf '#!/bin/bash\nsource lib/a.sh\n# shellcheck source=lib/b.sh\nsource "$B"\n. "$C"/c.sh\n' \
+  > "$sc_home"/s.sh
+printf 'source b.sh\n' > "$sc_home"/lib/a.sh
+printf '. a.sh\n' > "$sc_home"/lib/b.sh
+
+begin_test '_shellcheck_deps follows literal sources and directives'
+declare -A sc_deps=()
+(cd "$sc_home" && _shellcheck_deps "$sc_home"/s.sh && declare -p sc_deps) > "$sc_home"/deps
+source "$sc_home"/deps
+assert_equal "$sc_home/lib/a.sh $sc_home/lib/b.sh " "${sc_deps[$sc_home/s.sh]//$'\n'/ }" \
+  'literal source and directive; dynamic paths skipped' || true
+assert_equal "$sc_home/lib/b.sh" "${sc_deps[$sc_home/lib/a.sh]%$'\n'}" 'resolved beside the sourcing file' || true
+assert_equal 3 "${#sc_deps[@]}" 'each file visited once despite the cycle' || true
+
+begin_test '_shellcheck_keys changes when a sourced file does'
+sc_key_of() {
+  local -A sc_keys=()
+  local -- sc_spool
+  sc_spool=$(mktemp -d)
+  (cd "$sc_home" && _shellcheck_keys "$1" "$sc_home"/s.sh "$sc_home"/lib/b.sh \
+     && printf '%s\n' "${sc_keys[$sc_home/s.sh]}")
+  rm -rf "$sc_spool"
+}
+key=$(sc_key_of v1)
+assert_matches "$key" '^[0-9a-f]{64}$' 'sha256 key' || true
+assert_equal "$key" "$(sc_key_of v1)" 'stable' || true
+assert_not_contains "$(sc_key_of v2)" "$key" 'version in key' || true
+echo '# edit' >> "$sc_home"/lib/b.sh
+assert_not_contains "$(sc_key_of v1)" "$key" 'library edit' || true
+
+# --- Background pass and report cache (end to end) ---------------------------
+# bcs pins PATH to $HOME/.local/bin:..., so stubs dropped there stand in for
+# shellcheck (one finding per file, each run logged in $HOME/sc.calls) and
+# the Claude Code CLI (prompt appended to $HOME/prompts).
+cat > "$sc_home"/.local/bin/shellcheck <<'STUB'
+#!/usr/bin/env bash
+[[ $1 == --version ]] && { echo 'version: 0.0-stub'; exit 0; }
+echo "$*" >> "$HOME"/sc.calls
+shift 3
+sep='' out='['
+for f; do
+  out+="$sep{\"file\":\"$f\",\"line\":1,\"column\":1,\"level\":\"info\",\"code\":2148,\"message\":\"stub $f\"}"
+  sep=,
+done
+echo "$out]"
+exit 1
+STUB
+cat > "$sc_home"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+printf '%s\n' "${*: -1}" >> "$HOME"/prompts
+echo 'No findings.'
+STUB
+chmod +x "$sc_home"/.local/bin/*
+for f in one two three; do printf '#!/bin/bash\necho %s\n' "$f" > "$sc_home"/"$f".sh; done
+run_sc_check() {
+  isolated_bcs "$sc_home" BCS_CONF_DIR="$sc_home" check -q -m claude-code "$@"
+}
+sc_calls() { wc -l < "$sc_home"/sc.calls; }
+
+begin_test 'multi-file check runs shellcheck once and splits the report'
+run_sc_check --no-cache "$sc_home"/one.sh "$sc_home"/two.sh "$sc_home"/three.sh &>/dev/null ||:
+assert_equal 1 "$(sc_calls)" 'one shellcheck run' || true
+assert_contains "$(< "$sc_home"/sc.calls)" "$sc_home/one.sh $sc_home/two.sh $sc_home/three.sh" \
+  'over every file' || true
+assert_equal 3 "$(grep -c '"message":"stub' "$sc_home"/prompts)" 'one finding per prompt' || true
+assert_equal 1 "$(grep -c "stub $sc_home/two.sh" "$sc_home"/prompts)" 'each prompt gets its own file' || true
+
+begin_test 'cached reports are reused; only new scripts are checked'
+rm -f "$sc_home"/sc.calls "$sc_home"/prompts
+run_sc_check "$sc_home"/one.sh "$sc_home"/two.sh &>/dev/null ||:
+assert_equal 1 "$(sc_calls)" 'first cached run' || true
+run_sc_check -e high "$sc_home"/one.sh "$sc_home"/two.sh "$sc_home"/three.sh &>/dev/null ||:
+assert_equal 2 "$(sc_calls)" 'one more run' || true
+assert_equal "--format=json -x -- $sc_home/three.sh" "$(tail -n 1 "$sc_home"/sc.calls)" \
+  'over the uncached script only' || true
+assert_contains "$(tail -n 5 "$sc_home"/prompts)" 'stub' 'cached report still in the prompt' || true
+
+begin_test 'a check-cache hit does not run shellcheck'
+run_sc_check "$sc_home"/one.sh &>/dev/null ||:
+assert_equal 2 "$(sc_calls)" 'no run' || true
+
+begin_test 'editing a sourced file re-runs shellcheck'
+printf 'source lib/a.sh\n' >> "$sc_home"/one.sh
+run_sc_check "$sc_home"/one.sh &>/dev/null ||:
+echo '# edit' >> "$sc_home"/lib/a.sh
+run_sc_check -e low "$sc_home"/one.sh &>/dev/null ||:
+assert_equal 4 "$(sc_calls)" 'script edit, then library edit' || true
+
+begin_test 'bcs cache counts and prunes shellcheck reports'
+output=$(HOME="$sc_home" XDG_CACHE_HOME="$sc_home"/cache "$BCS_CMD" cache stats)
+assert_contains "$output" 'Reports: 5 (shellcheck)' 'reports counted apart' || true
+HOME="$sc_home" XDG_CACHE_HOME="$sc_home"/cache "$BCS_CMD" -q cache prune &>/dev/null ||:
+output=$(HOME="$sc_home" XDG_CACHE_HOME="$sc_home"/cache "$BCS_CMD" cache stats)
+assert_contains "$output" 'Reports: 0' 'pruned with the results' || true
+
+begin_test '--no-shellcheck starts no shellcheck'
+run_sc_check --no-cache --no-shellcheck "$sc_home"/two.sh &>/dev/null ||:
+assert_equal 4 "$(sc_calls)" 'no run' || true
+
 print_summary 'check-shellcheck'
 #fin
@@ -0,0 +1,147 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-chunked-check.sh - Chunked review of long scripts (bcs check --chunk-lines)
+#
+# Unit-tests _chunk_ranges/_chunk_excerpt on a generated script, then runs
+# `bcs check --chunk-lines` with a stub Claude CLI to verify every chunk is
+# reviewed with the shared preamble, and that findings are merged without
+# duplicates and per-chunk timings are reported.
+
+set -euo pipefail
+shopt -s inherit_errexit
+
+#shellcheck source=tests/test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+#shellcheck source=bcs
+source "$BCS_CMD"   # source guard keeps main() from running
+
+echo 'Testing: chunked check'
+
+declare -- WORK
+WORK=$(mktemp -d) || { echo 'mktemp failed' >&2; exit 1; }
+trap 'rm -rf "$WORK"' EXIT
+
+# Preamble of 4 lines, then four 10-line functions (lines 5-44), then main.
+declare -- S="$WORK"/long.sh
+{
+  printf '#!/usr/bin/env bash\nset -euo pipefail\ndeclare -r X=1\n\n'
+  for f in one two three four; do
+    printf '%s() {\n' "$f"
+    printf '  echo %s\n' 1 2 3 4 5 6 7
+    printf '}\n\n'
+  done
+  printf 'main() { one; }\nmain "$@"\n#fin\n'
+} > "$S"
+
+# --- _chunk_ranges / _chunk_excerpt -----------------------------------------
+
+begin_test 'ranges cut at function boundaries after the preamble'
+assert_equal $'5 24\n25 44\n45 47' "$(_chunk_ranges "$S" 20)" 'two functions per chunk' || true
+assert_equal $'5 14\n15 24\n25 34\n35 44\n45 47' "$(_chunk_ranges "$S" 12)" 'one function per chunk' || true
+
+begin_test 'ranges cut before every function declaration style'
+# Same layout, declared as `function NAME {`, `function NAME() {` and
+# `function NAME` with the brace on the next line
+declare -- F="$WORK"/keyword.sh
+{
+  printf '#!/usr/bin/env bash\nset -euo pipefail\ndeclare -r X=1\n\n'
+  printf 'function one {\n'; printf '  echo %s\n' 1 2 3 4 5 6 7; printf '}\n\n'
+  printf 'function two() {\n'; printf '  echo %s\n' 1 2 3 4 5 6 7; printf '}\n\n'
+  printf 'function three\n{\n'; printf '  echo %s\n' 1 2 3 4 5 6; printf '}\n\n'
+  printf 'four() {\n'; printf '  echo %s\n' 1 2 3 4 5 6 7; printf '}\n\n'
+  printf 'main() { one; }\nmain "$@"\n#fin\n'
+} > "$F"
+assert_equal "$(_chunk_ranges "$S" 12)" "$(_chunk_ranges "$F" 12)" 'same cuts as name() {' || true
+
+begin_test 'oversized function is cut mid-body'
+assert_equal '5 9' "$(_chunk_ranges "$S" 5 | head -n1)" 'hard cut at 5 lines' || true
+
+begin_test 'excerpt carries preamble, overlap and real line numbers'
+declare -- excerpt
+excerpt=$(_chunk_excerpt "$S" 4 25 44 3)
+assert_contains "$excerpt" '   3: declare -r X=1' 'preamble kept' || true
+assert_contains "$excerpt" '  22: ' 'overlap context kept' || true
+assert_not_contains "$excerpt" '  21: ' 'earlier lines elided' || true
+assert_contains "$excerpt" '  44: ' 'chunk end kept' || true
+assert_not_contains "$excerpt" '  45: ' 'later lines elided' || true
+assert_contains "$excerpt" '    ...' 'elision marker' || true
+
+begin_test 'chunk workers are reaped without waiting on other children'
+out=$(
+  _llm_review() { echo '[]'; }
+  declare -a chunks=('5 24' '25 44' '45 47')
+  declare -- script_file=$S backend=mock result='' chunk_meta=''
+  declare -i max_jobs=1 json_output=1 exit_code=0
+  sleep 3 >/dev/null &
+  SECONDS=0
+  _check_chunks
+  printf '%d %s' "$SECONDS" "$(wc -l <<< "$chunk_meta")"
+)
+assert_equal '0 3' "$out" 'an unrelated 3s child is left alone' || true
+
+# --- End to end -------------------------------------------------------------
+
+mkdir -p "$WORK"/.local/bin
+# Stub Claude CLI: keep each @-referenced listing, then report the preamble
+# (seen by every chunk) plus the first line of its own chunk.
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+f=$(grep -o 'Analyze @[^ ]*' <<< "${*: -1}")
+f=${f#Analyze @}
+lo=$(grep -o 'Report findings on lines [0-9]*' <<< "${*: -1}")
+lo=${lo##* }; lo=${lo:-1}
+cp "$f" "$HOME/sent.$lo"
+sleep "${STUB_DELAY:-0}"
+echo "[{\"line\":2,\"level\":\"error\",\"bcsCode\":\"BCS0101\",\"tier\":\"core\",\"message\":\"pre\"},
+      {\"line\":$lo,\"level\":\"warning\",\"bcsCode\":\"BCS0702\",\"tier\":\"recommended\",\"message\":\"c\"}]"
+STUB
+chmod +x "$WORK"/.local/bin/claude
+
+run_check() {
+  isolated_check "$WORK" BCS_CONF_DIR="$WORK" --no-cache -m claude-code "$@"
+}
+
+begin_test 'check --chunk-lines reviews each chunk and merges findings'
+declare -- out err
+declare -i rc=0
+out=$(run_check -j -v --chunk-lines 20 "$S" 2>"$WORK"/err) || rc=$?
+err=$(< "$WORK"/err)
+assert_equal 1 "$rc" 'exit 1 on the core finding' || true
+assert_equal 'BCS0101:2 BCS0702:5 BCS0702:25 BCS0702:45' \
+  "$(jq -r '[.comments[] | "\(.bcsCode):\(.line)"] | join(" ")' <<< "$out")" \
+  'preamble finding reported once, one per chunk' || true
+assert_equal 3 "$(jq '.meta.chunks | length' <<< "$out")" 'meta.chunks lists three chunks' || true
+assert_equal '[25,44]' "$(jq -c '.meta.chunks[1].lines' <<< "$out")" 'chunk ranges' || true
+assert_contains "$err" 'Chunk 2/3 (lines 25-44): ' 'per-chunk timing line' || true
+assert_contains "$(< "$WORK"/sent.45)" '   2: set -euo pipefail' 'every chunk carries the preamble' || true
+assert_not_contains "$(< "$WORK"/sent.45)" '   5: one() {' 'other chunks elided' || true
+
+begin_test 'chunks run concurrently'
+declare -i t0=$SECONDS
+SECONDS=0
+STUB_DELAY=1 run_check -j -q --chunk-lines 12 -P 5 "$S" &>/dev/null || true
+assert_lt "$SECONDS" 4 'five 1s chunks finish well under their sum' || true
+SECONDS=$t0
+
+begin_test 'chunking is off with --chunk-lines 0'
+rm -f "$WORK"/sent.*
+out=$(run_check -j -q --chunk-lines 0 "$S" 2>/dev/null) || true
+assert_equal null "$(jq -c '.meta.chunks' <<< "$out")" 'no meta.chunks' || true
+assert_contains "$(cat "$WORK"/sent.* 2>/dev/null)" 'one() {' 'whole script sent in one request' || true
+
+begin_test 'text mode drops repeated finding lines'
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+echo '[ERROR] BCS0101 line 2: missing strict mode'
+STUB
+out=$(run_check -q --chunk-lines 20 "$S" 2>/dev/null) || true
+assert_equal 1 "$(grep -c 'BCS0101 line 2' <<< "$out")" 'reported once' || true
+assert_contains "$out" '### Chunk 3/3: lines 45-47' 'per-chunk headings' || true
+
+begin_test 'invalid chunk size is rejected'
+rc=0
+run_check --chunk-lines lots "$S" &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'exit 22' || true
+
+print_summary 'chunked-check'
+#fin
@@ -17,26 +17,33 @@ source "$BCS_CMD"
 echo 'Testing: effort -> API parameter wiring'
 
 # ---------------------------------------------------------------------
-# Mock curl: read stdin via -d @-, dump body to $PAYLOAD_FILE, then emit
-# a minimal "successful" response that satisfies each backend's parser
-# (jq -r '.content[0].text', '.choices[0].message.content',
-# '.candidates[0].content.parts[0].text', '.message.content') plus a
-# trailing HTTP code so the API-failure check passes.
+# Mock curl: read the body given by -d (@- stdin, @FILE, or literal),
+# dump it to $PAYLOAD_FILE, then emit a minimal "successful" response that
+# satisfies each backend's parser (jq -r '.content[0].text',
+# '.choices[0].message.content', '.candidates[0].content.parts[0].text',
+# '.message.content') -- into the -o file when given, as the retrying
+# transport asks -- plus the ___CURL___ write-out trailer (HTTP code and
+# transfer times) so the API-failure check passes.
 # ---------------------------------------------------------------------
 PAYLOAD_FILE=$(mktemp /tmp/bcs-payload.XXXXXX)
 trap 'rm -f "$PAYLOAD_FILE"' EXIT
 
 curl() {
-  local -- arg body=''
-  for arg in "$@"; do
-    if [[ $body == '__pending__' ]]; then
-      [[ $arg == '@-' ]] && body=$(cat) || body=$arg
-      break
-    fi
-    [[ $arg == '-d' ]] && body='__pending__' ||:
+  local -- body='' out=/dev/stdout
+  while (($#)); do
+    case $1 in
+      -d) shift
+          case $1 in
+            @-) body=$(cat) ;;
+            @*) body=$(< "${1#@}") ;;
+            *)  body=$1 ;;
+          esac ;;
+      -o) shift; out=$1 ;;
+    esac
+    shift
   done
   printf '%s' "$body" > "$PAYLOAD_FILE"
-  printf '%s\n200\n' '{"content":[{"text":"[]"}],
+  printf '%s' '{"content":[{"text":"[]"}],
                        "choices":[{"message":{"content":"[]"}}],
                        "candidates":[{"content":{"parts":[{"text":"[]"}]}}],
                        "message":{"content":"[]"},
@@ -44,7 +51,8 @@ curl() {
                                 "prompt_tokens":1,"completion_tokens":1},
                        "usageMetadata":{"promptTokenCount":1,
                                         "candidatesTokenCount":1},
-                       "prompt_eval_count":1,"eval_count":1}'
+                       "prompt_eval_count":1,"eval_count":1}' > "$out"
+  printf '\n___CURL___ 200 0.000100 0.000000 0.000200 0.000300\n'
 }
 export -f curl
 
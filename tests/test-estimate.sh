@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-estimate.sh - Pre-flight forecasts (bcs check --estimate and
+# --auto-effort) and the run history records they are calibrated from,
+# against the local HTTP stand-in playing the Anthropic Messages API.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: estimate'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+seq 1 3000 | sed 's/^/echo /' > "$work"/big.sh
+hist="$work"/state/bcs/runs.ndjson
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="${STANDIN_URL:-http://127.0.0.1:9}" \
+    ANTHROPIC_API_KEY=test-key BCS_RETRY_BASE_MS=20 "$@"
+}
+
+# Five haiku reviews where output grows 40 tokens per finding over a
+# base of 100, and each output token takes 10 ms over a base of 2 s
+seed_history() {
+  local -i i
+  mkdir -p "${hist%/*}"
+  : > "$hist"
+  for i in 1 2 3 4 5; do
+    printf '{"ts":%d,"backend":"anthropic","model":"claude-haiku-4-5","effort":"medium","json":false,"cache":false,"lines":%d,"requests":1,"prompt_bytes":%d,"tokens":{"in":%d,"out":%d},"llm_ms":%d,"findings":{"error":%d,"warning":%d},"exit":1}\n' \
+      "$EPOCHSECONDS" $((i * 100)) $((40000 + i * 1000)) \
+      $((10000 + i * 300)) $((100 + i * 160)) $((2000 + (100 + i * 160) * 10)) $((i * 2)) $((i * 2)) >> "$hist"
+  done
+  # Cache hits and mock runs carry no prompt bytes and are not fitted
+  printf '{"ts":%d,"backend":"anthropic","model":"claude-haiku-4-5","json":false,"lines":100,"requests":1,"prompt_bytes":0,"tokens":{"in":0,"out":0},"llm_ms":0,"findings":{"error":50,"warning":0}}\n' \
+    "$EPOCHSECONDS" >> "$hist"
+}
+
+# ---------------------------------------------------------------------
+# Forecasts
+# ---------------------------------------------------------------------
+begin_test 'with no history the defaults apply'
+declare -i rc=0
+out=$(run_check --estimate -m claude-haiku-4-5 "$work"/s.sh 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0' || true
+assert_contains "$out" 'Estimate: ' 'estimate printed' || true
+assert_contains "$out" 'defaults' 'from the defaults' || true
+assert_contains "$out" 'unknown (no history for claude-haiku-4-5)' 'latency unknown' || true
+assert_contains "$out" 'Truncation: unlikely' 'small script fits' || true
+assert_equal missing "$([[ -f $hist ]] && echo present || echo missing)" 'no call, no history' || true
+
+begin_test 'history calibrates output, ratio and latency'
+seed_history
+out=$(run_check --estimate --chunk-lines 0 -e low -m claude-haiku-4-5 "$work"/big.sh 2>/dev/null)
+assert_contains "$out" '~4900 tokens of 4000 max' 'output fitted on findings' || true
+assert_contains "$out" 'calibrated from 5 checks' 'fit size shown' || true
+assert_contains "$out" '3.94 bytes/token' 'ratio from history' || true
+assert_contains "$out" '~51.0s (100 output tokens/s' 'latency from history' || true
+assert_contains "$out" 'likely -- use -e medium' 'next effort suggested' || true
+
+begin_test 'chunked checks are forecast per request'
+out=$(run_check --estimate -e low -m claude-haiku-4-5 "$work"/big.sh 2>/dev/null)
+assert_contains "$out" '5 requests' 'chunk count' || true
+assert_contains "$out" '~1060 tokens per request' 'output per chunk' || true
+assert_contains "$out" 'Truncation: unlikely' 'chunks fit' || true
+
+begin_test '-j prints one JSON estimate'
+out=$(run_check --estimate -j --chunk-lines 0 -e low -m claude-haiku-4-5 "$work"/big.sh 2>/dev/null)
+# No JSON-mode reviews in the history: output from the JSON defaults,
+# latency still from the model's timings
+assert_equal 'true high 4000 0 5' \
+  "$(jq -r '.estimate | "\(.truncation_likely) \(.suggested_effort) \(.max_tokens) \(.history.output) \(.history.latency)"' <<< "$out")" \
+  'truncation, suggestion, max_tokens, history' || true
+
+begin_test 'thinking budget is reserved'
+out=$(run_check --estimate -j -e high -m claude-opus-4-6 "$work"/s.sh 2>/dev/null)
+assert_gt "$(jq -r '.estimate.thinking_tokens' <<< "$out")" 0 'opus thinks' || true
+assert_gt "$(jq -r '.estimate.output_tokens - .estimate.thinking_tokens' <<< "$out")" 0 \
+  'output on top of thinking' || true
+out=$(run_check --estimate -j -e high -m claude-haiku-4-5 "$work"/s.sh 2>/dev/null)
+assert_equal 0 "$(jq -r '.estimate.thinking_tokens' <<< "$out")" 'haiku does not' || true
+
+begin_test 'option conflicts'
+rc=0
+run_check --estimate --engine static "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'static engine -> 22' || true
+rc=0
+run_check --estimate --batch-submit "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" '--batch-submit -> 22' || true
+
+# ---------------------------------------------------------------------
+# Recording and --auto-effort (need the HTTP stand-in)
+# ---------------------------------------------------------------------
+if ! start_http_standin "$work"; then
+  echo '  (skipping - python3 not available)'
+  print_summary 'estimate'
+  exit
+fi
+reset_standin() { rm -f "$work"/req.* "$work"/response.* "$work"/status*; }
+
+begin_test 'a live review records its prompt bytes in the run history'
+rm -f "$hist"
+echo '{"content":[{"type":"text","text":"[WARN] BCS0702 line 2: a\n[ERROR] BCS0101 line 1: b"}],
+       "usage":{"input_tokens":900,"cache_read_input_tokens":100,"output_tokens":42}}' \
+  > "$work"/response.json
+run_check --no-cache -m claude-haiku-4-5 "$work"/s.sh &>/dev/null ||:
+assert_file_exists "$hist" 'history written' || true
+assert_equal 'anthropic claude-haiku-4-5 medium false 1 2 1 1 1000 42' \
+  "$(jq -r '[.backend, .model, .effort, .json, .requests, .lines, .findings.error,
+             .findings.warning, .tokens.in, .tokens.out] | join(" ")' "$hist")" \
+  'one record: findings and tokens' || true
+assert_gt "$(jq -r .prompt_bytes "$hist")" 1000 'prompt bytes' || true
+assert_equal missing "$([[ -e $work/state/bcs/usage.tsv ]] && echo present || echo missing)" \
+  'no second log' || true
+
+begin_test 'mock reviews do not calibrate'
+rm -f "$hist"
+mkdir -p "$work"/mock
+printf '[WARN] BCS0702 line 2: a\n' > "$work"/mock/default.txt
+run_check --no-cache -m mock:"$work"/mock "$work"/s.sh &>/dev/null ||:
+assert_equal 0 "$(jq -r '.prompt_bytes' "$hist" 2>/dev/null)" 'no prompt bytes' || true
+
+begin_test '--auto-effort raises max_tokens to fit the forecast'
+seed_history
+reset_standin
+echo '{"content":[{"type":"text","text":"ok"}],"usage":{"input_tokens":9,"output_tokens":1}}' \
+  > "$work"/response.json
+err=$(run_check --no-cache --chunk-lines 0 -e low --auto-effort -m claude-haiku-4-5 \
+        "$work"/big.sh 2>&1 >/dev/null) ||:
+assert_contains "$err" "using 'medium'" 'effort raised' || true
+assert_equal 8000 "$(jq -r '.max_tokens' "$work"/req.1.json)" 'medium max_tokens' || true
+reset_standin
+run_check --no-cache --chunk-lines 0 -e low -m claude-haiku-4-5 "$work"/big.sh &>/dev/null ||:
+assert_equal 4000 "$(jq -r '.max_tokens' "$work"/req.1.json)" 'off by default' || true
+
+print_summary 'estimate'
+#fin
@@ -205,6 +205,108 @@ assert_superset() {
   fi
 }
 
+# Run bcs with a private HOME (DIR) and XDG state and cache dirs under it,
+# so run history, caches and latency samples stay inside the suite's temp
+# dir. Leading NAME=VALUE words are added to the environment (and win over
+# the defaults); the remaining words are the bcs arguments.
+# Usage: isolated_bcs DIR [NAME=VALUE...] ARGS...
+isolated_bcs() {
+  local -- dir=$1
+  local -a vars=()
+  shift
+  while (($#)) && [[ $1 =~ ^[A-Za-z_][A-Za-z0-9_]*= ]]; do
+    vars+=("$1")
+    shift
+  done
+  env HOME="$dir" XDG_STATE_HOME="$dir"/state XDG_CACHE_HOME="$dir"/cache \
+    "${vars[@]}" "$BCS_CMD" "$@"
+}
+
+# isolated_bcs for `bcs check --no-shellcheck ARGS...`.
+# Usage: isolated_check DIR [NAME=VALUE...] [ARGS...]
+isolated_check() {
+  local -- dir=$1
+  local -a vars=()
+  shift
+  while (($#)) && [[ $1 =~ ^[A-Za-z_][A-Za-z0-9_]*= ]]; do
+    vars+=("$1")
+    shift
+  done
+  isolated_bcs "$dir" "${vars[@]}" check --no-shellcheck "$@"
+}
+
+# Local HTTP stand-in for LLM APIs. Serves 127.0.0.1 on an ephemeral port
+# so backend tests can point *_BASE_URL at it and assert the exact request
+# bcs sends -- curl, headers and all -- without network access or keys.
+#
+# Usage: start_http_standin DIR   (sets STANDIN_URL and STANDIN_PID)
+#   Request N (1-based) is recorded as DIR/req.N.json (body) and
+#   DIR/req.N.head ("METHOD /path" then one "name: value" header per line).
+#   It is answered with DIR/response.N.json, else DIR/response.json, with
+#   status DIR/status.N, else DIR/status, else 200, after DIR/delay.N, else
+#   DIR/delay, seconds of injected latency (none when absent). Extra
+#   response headers ("Name: value" lines) come from DIR/headers.N, else
+#   DIR/headers. Requests are served concurrently; N counts the req.*.json
+#   files present, so deleting them restarts the numbering.
+# Returns 1 when python3 is unavailable; callers skip their HTTP tests.
+declare -- STANDIN_URL='' STANDIN_PID=''
+start_http_standin() {
+  local -- dir=$1
+  command -v python3 &>/dev/null || return 1
+  rm -f -- "$dir"/port
+  python3 - "$dir" <<'PY' &
+import glob, http.server, os, sys, threading, time
+d = sys.argv[1]
+lock = threading.Lock()
+def pick(name, ext, default, i):
+    for cand in (f'{name}.{i}{ext}', f'{name}{ext}'):
+        p = os.path.join(d, cand)
+        if os.path.exists(p):
+            return open(p, 'rb').read()
+    return default
+class H(http.server.BaseHTTPRequestHandler):
+    def do_POST(self):
+        with lock:
+            i = len(glob.glob(os.path.join(d, 'req.*.json'))) + 1
+            open(os.path.join(d, f'req.{i}.json'), 'wb').close()
+        body = self.rfile.read(int(self.headers.get('Content-Length') or 0))
+        open(os.path.join(d, f'req.{i}.json'), 'wb').write(body)
+        with open(os.path.join(d, f'req.{i}.head'), 'w') as f:
+            f.write(f'{self.command} {self.path}\n')
+            f.writelines(f'{k.lower()}: {v}\n' for k, v in self.headers.items())
+        out = pick('response', '.json', b'{}', i)
+        time.sleep(float(pick('delay', '', b'0', i)))
+        self.send_response(int(pick('status', '', b'200', i)))
+        self.send_header('Content-Type', 'application/json')
+        for line in pick('headers', '', b'', i).decode().splitlines():
+            k, _, v = line.partition(':')
+            self.send_header(k.strip(), v.strip())
+        self.send_header('Content-Length', str(len(out)))
+        self.end_headers()
+        self.wfile.write(out)
+    do_GET = do_POST
+    def log_message(self, *a):
+        pass
+srv = http.server.ThreadingHTTPServer(('127.0.0.1', 0), H)
+open(os.path.join(d, 'port'), 'w').write(str(srv.server_port))
+srv.serve_forever()
+PY
+  STANDIN_PID=$!
+  local -i tries
+  for ((tries = 0; tries < 50; tries+=1)); do
+    [[ -s $dir/port ]] && break
+    sleep 0.1
+  done
+  [[ -s $dir/port ]] || { kill "$STANDIN_PID" 2>/dev/null; return 1; }
+  STANDIN_URL=http://127.0.0.1:$(< "$dir"/port)
+}
+
+# Stop the stand-in started by start_http_standin (safe to call twice).
+stop_http_standin() {
+  [[ -z $STANDIN_PID ]] || kill "$STANDIN_PID" 2>/dev/null ||:
+  STANDIN_PID=''
+}
+
 # Print test summary
 # 'run' is the total number of assertions evaluated (passed + failed), so the
 # count always partitions cleanly. begin_test groups assertions under a label
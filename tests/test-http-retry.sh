@@ -0,0 +1,186 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-http-retry.sh - Shared HTTP layer: retry/backoff, Retry-After,
+# per-backend request slots and hedged requests, exercised against a local
+# HTTP stand-in that fails, stalls or throttles on cue.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: HTTP retries and hedging'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+# Run a bcs function in a fresh shell
+bcs_fn() { bash -c 'source "$1"; shift; "$@"' _ "$BCS_CMD" "$@"; }
+
+# ---------------------------------------------------------------------
+# Retry policy (no HTTP needed)
+# ---------------------------------------------------------------------
+begin_test 'transient statuses and dropped connections are retryable'
+declare -- verdicts='' c
+for c in '429 0' '529 0' '503 0' '400 0' '401 0' '200 0' '0 28' '0 56' '0 7' '0 6'; do
+  # shellcheck disable=SC2086
+  bcs_fn _http_retryable $c && verdicts+=y || verdicts+=n
+done
+assert_equal yyynnnyynn "$verdicts" '429 529 503 | 400 401 200 | curl 28 56 | curl 7 6' || true
+
+begin_test 'Retry-After wins over backoff, in seconds or as a date'
+printf 'HTTP/1.1 429\r\nRetry-After: 3\r\n\r\n' > "$work"/h1
+assert_equal 3000 "$(bcs_fn _http_backoff_ms 1 "$work"/h1)" 'seconds' || true
+printf 'retry-after: %s\r\n' "$(date -u -d '+5 seconds' '+%a, %d %b %Y %H:%M:%S GMT')" > "$work"/h2
+ms=$(bcs_fn _http_backoff_ms 1 "$work"/h2)
+assert_gt "$ms" 3000 'HTTP date ~5s ahead' || true
+assert_lt "$ms" 6001 'HTTP date not beyond 5s' || true
+printf 'retry-after: 600\r\n' > "$work"/h3
+assert_equal 60000 "$(bcs_fn _http_backoff_ms 1 "$work"/h3)" 'capped at BCS_RETRY_MAX_MS' || true
+
+begin_test 'backoff doubles per attempt with jitter in the upper half'
+declare -i lo=999999 hi=0 i
+for i in {1..20}; do
+  ms=$(BCS_RETRY_BASE_MS=400 bcs_fn _http_backoff_ms 3 /dev/null)
+  ((ms >= lo)) || lo=ms
+  ((ms <= hi)) || hi=ms
+done
+assert_gt "$lo" 799 'attempt 3 waits at least 2 x base' || true
+assert_lt "$hi" 1601 'and at most 4 x base' || true
+assert_gt "$hi" "$lo" 'jittered' || true
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping HTTP stand-in tests - python3 not available)'
+  print_summary 'http-retry'
+  exit
+fi
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+cp "$work"/s.sh "$work"/t.sh
+jq -n '{content: [{type: "text",
+                   text: "[{\"line\":2,\"level\":\"warning\",\"bcsCode\":\"BCS0702\",\"message\":\"x\"}]"}],
+        usage: {input_tokens: 5, output_tokens: 2}}' > "$work"/response.json
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+    BCS_RETRY_BASE_MS=20 --no-cache -m claude-haiku-4-5 "$@"
+}
+# Clear the stand-in's request log and cues
+reset_standin() { rm -f "$work"/req.* "$work"/status* "$work"/delay* "$work"/headers*; }
+requests() { find "$work" -maxdepth 1 -name 'req.*.json' | wc -l; }
+
+# ---------------------------------------------------------------------
+# Retries
+# ---------------------------------------------------------------------
+begin_test 'a 429 then a 529 are retried and reported'
+reset_standin
+echo 429 > "$work"/status.1
+echo 529 > "$work"/status.2
+declare -i rc=0
+out=$(run_check -j "$work"/s.sh 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'check succeeds' || true
+assert_equal 3 "$(requests)" 'three requests' || true
+assert_equal '["http 429","http 529"]' "$(jq -c '.meta.http.retries' <<< "$out")" 'meta.http.retries' || true
+assert_equal BCS0702 "$(jq -r '.comments[0].bcsCode' <<< "$out")" 'final answer parsed' || true
+
+begin_test 'retries show up in the diagnostics'
+reset_standin
+echo 503 > "$work"/status.1
+err=$(run_check -v "$work"/s.sh 2>&1 >/dev/null) || true
+assert_contains "$err" 'anthropic: HTTP 503 -- retry 1/3' 'live notice' || true
+assert_contains "$err" 'HTTP: 1 retries (http 503), 0 hedged, 0 hedge wins' 'summary' || true
+
+begin_test 'Retry-After is honoured'
+reset_standin
+echo 429 > "$work"/status.1
+echo 'Retry-After: 1' > "$work"/headers.1
+t0=${EPOCHREALTIME/./}
+run_check "$work"/s.sh &>/dev/null || true
+assert_gt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 999 'waited at least 1s' || true
+
+begin_test 'permanent errors and --retries 0 fail at once'
+reset_standin
+echo 400 > "$work"/status
+rc=0
+run_check "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 5:1 "$rc:$(requests)" '400 -> exit 5 after one request' || true
+reset_standin
+echo 529 > "$work"/status
+rc=0
+run_check --retries 0 "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 5:1 "$rc:$(requests)" '--retries 0' || true
+rc=0
+run_check --retries 2 "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 5:4 "$rc:$(requests)" '--retries 2 gives up after three attempts' || true
+rc=0
+run_check --retries x "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'invalid count' || true
+
+begin_test 'the request spool is removed when an attempt dies'
+mkdir -p "$work"/tmp
+out=$(bash -c 'source "$1"; export TMPDIR="$2"/tmp
+  curl() { printf "___CURL___ 503 0 0.1"; }
+  _http_retry() { die 5 "gave up"; }
+  raw=$(_http_post anthropic "" <<< "{}") || echo "rc=$?"
+  find "$TMPDIR" -mindepth 1 | wc -l' _ "$BCS_CMD" "$work" 2>/dev/null)
+assert_equal $'rc=5\n0' "$out" 'no spool left behind' || true
+
+begin_test 'streamed requests are retried before any text is shown'
+reset_standin
+echo 503 > "$work"/status.1
+printf 'data: %s\n\n' \
+  '{"type":"content_block_delta","index":0,"delta":{"type":"text_delta","text":"[WARN] BCS0702 line 2: s"}}' \
+  > "$work"/response.2.json
+out=$(run_check --stream "$work"/s.sh 2>/dev/null) || true
+assert_equal '[WARN] BCS0702 line 2: s' "$out" 'one clean report' || true
+assert_equal 2 "$(requests)" 'two requests' || true
+rm -f "$work"/response.2.json
+
+begin_test 'a stream cut after live text is not retried'
+# Stub curl: one text event, then a dropped connection (exit 56)
+out=$(bash -c 'source "$1"; cd "$2"
+  curl() { echo call >> calls; printf "data: %s\n\n" "{\"t\":\"partial\\n\"}"; return 56; }
+  exec 3>live
+  BCS_STREAM_FD=3 BCS_RETRIES=2 _stream_post "$2"/st .t anthropic "" <<< "{}" >/dev/null || echo "rc=$?"
+  echo "$(wc -l < calls) $(< live)"' _ "$BCS_CMD" "$work" 2>/dev/null)
+assert_equal $'rc=56\n1 partial' "$out" 'one request, text shown once' || true
+rm -f "$work"/calls "$work"/live "$work"/st.*
+
+# ---------------------------------------------------------------------
+# Hedging and slots
+# ---------------------------------------------------------------------
+begin_test 'a stalled request is hedged and the hedge wins'
+reset_standin
+echo 3 > "$work"/delay.1
+t0=${EPOCHREALTIME/./}
+out=$(BCS_HEDGE_MS=300 run_check -j --hedge "$work"/s.sh 2>/dev/null) || true
+assert_lt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 2500 'did not wait for the stalled request' || true
+assert_equal '1 1' "$(jq -r '"\(.meta.http.hedged) \(.meta.http.hedge_wins)"' <<< "$out")" \
+  'meta.http hedged/hedge_wins' || true
+assert_equal BCS0702 "$(jq -r '.comments[0].bcsCode' <<< "$out")" 'hedge answer parsed' || true
+
+begin_test 'a fast answer is never hedged'
+reset_standin
+out=$(BCS_HEDGE_MS=2000 run_check -j --hedge "$work"/s.sh 2>/dev/null) || true
+assert_equal 1 "$(requests)" 'one request' || true
+assert_equal null "$(jq -c '.meta.http' <<< "$out")" 'no meta.http' || true
+
+begin_test 'hedge delay defaults to the recorded p95'
+hist=$(XDG_STATE_HOME="$work"/state bcs_fn _http_history anthropic claude-haiku-4-5 medium)
+assert_gt "$(wc -l < "$hist")" 0 'successful requests recorded' || true
+seq 1 100 > "$work"/lat
+assert_equal 95 "$(bcs_fn _http_hedge_ms "$work"/lat)" 'p95 of 1..100' || true
+seq 1 10 > "$work"/lat
+assert_equal 0 "$(bcs_fn _http_hedge_ms "$work"/lat)" 'too few samples: no hedge' || true
+
+begin_test 'BCS_MAX_INFLIGHT serialises requests across pool workers'
+reset_standin
+echo 1 > "$work"/delay
+t0=${EPOCHREALTIME/./}
+BCS_MAX_INFLIGHT=1 run_check -P 2 "$work"/s.sh "$work"/t.sh &>/dev/null || true
+assert_gt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 1999 'one at a time' || true
+t0=${EPOCHREALTIME/./}
+run_check -P 2 "$work"/s.sh "$work"/t.sh &>/dev/null || true
+assert_lt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 2000 'unlimited by default' || true
+
+print_summary 'http-retry'
+#fin
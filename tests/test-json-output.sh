@@ -2,8 +2,9 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 # test-json-output.sh - Offline unit tests for JSON output helpers
 #
-# Sources the bcs script to exercise _strip_json_fences and
-# _render_json_output directly with canned LLM output. No backend needed.
+# Sources the bcs script to exercise the shared jq definitions
+# (FINDINGS_JQ), _llm_fields and _render_json_output directly with canned
+# LLM output. No backend needed.
 set -euo pipefail
 shopt -s inherit_errexit
 
@@ -14,27 +15,29 @@ source "$BCS_CMD"   # source guard keeps main() from running
 
 echo 'Testing: json-output helpers'
 
-# ---- _strip_json_fences ---------------------------------------------------
+# ---- unfence (FINDINGS_JQ) -------------------------------------------------
+
+unfence() { jq -nr --arg raw "$1" "$FINDINGS_JQ"' $raw | unfence'; }
 
 begin_test 'strip fences: bare array unchanged'
 input='[{"line":1,"level":"error","bcsCode":"BCS0101"}]'
-assert_equal "$input" "$(_strip_json_fences "$input")"
+assert_equal "$input" "$(unfence "$input")"
 
 begin_test 'strip fences: triple-backtick wrapper'
 input=$'```\n[{"a":1}]\n```'
-assert_equal '[{"a":1}]' "$(_strip_json_fences "$input")"
+assert_equal '[{"a":1}]' "$(unfence "$input")"
 
 begin_test 'strip fences: ```json wrapper'
 input=$'```json\n[{"a":1}]\n```'
-assert_equal '[{"a":1}]' "$(_strip_json_fences "$input")"
+assert_equal '[{"a":1}]' "$(unfence "$input")"
 
 begin_test 'strip fences: surrounding whitespace'
 input=$'   \n\n[{"a":1}]\n  \n'
-assert_equal '[{"a":1}]' "$(_strip_json_fences "$input")"
+assert_equal '[{"a":1}]' "$(unfence "$input")"
 
 begin_test 'strip fences: combined json wrapper + whitespace'
 input=$'\n\n```json\n[{"x":2}]\n```\n\n'
-assert_equal '[{"x":2}]' "$(_strip_json_fences "$input")"
+assert_equal '[{"x":2}]' "$(unfence "$input")"
 
 # ---- _render_json_output: happy path -------------------------------------
 
@@ -145,23 +148,57 @@ out=$(_render_json_output "$arr" /tmp/x.sh anthropic claude-haiku-4-5 medium 1 4
 meta_keys=$(jq -r '.meta | keys_unsorted | sort | join(",")' <<< "$out")
 assert_equal 'backend,effort,elapsed_s,file,model,strict,tool,version' "$meta_keys" 'meta keys'
 
-# ---- _extract_anthropic_text (thinking-block regression, T-01) ------------
+# ---- ANTHROPIC_FIELDS via _llm_fields (thinking-block regression, T-01) ---
+
+anthropic_text() {
+  local -- errmsg tkn text
+  _llm_fields "$ANTHROPIC_FIELDS" "$1" || return 1
+  printf '%s\n' "$text"
+}
 
 begin_test 'extract: thinking block at content[0] is skipped, text returned'
 body='{"content":[{"type":"thinking","thinking":"reasoning..."},{"type":"text","text":"[]"}]}'
-assert_equal '[]' "$(_extract_anthropic_text <<< "$body")"
+assert_equal '[]' "$(anthropic_text "$body")"
 
 begin_test 'extract: multiple text blocks are concatenated in order'
 body='{"content":[{"type":"text","text":"foo"},{"type":"text","text":"bar"}]}'
-assert_equal 'foobar' "$(_extract_anthropic_text <<< "$body")"
+assert_equal 'foobar' "$(anthropic_text "$body")"
 
 begin_test 'extract: typeless block with .text still extracted (mock-compat)'
 body='{"content":[{"text":"hi"}]}'
-assert_equal 'hi' "$(_extract_anthropic_text <<< "$body")"
+assert_equal 'hi' "$(anthropic_text "$body")"
 
 begin_test 'extract: thinking-only body yields empty (guarded as error upstream)'
 body='{"content":[{"type":"thinking","thinking":"only thinking"}]}'
-assert_equal '' "$(_extract_anthropic_text <<< "$body")"
+assert_equal '' "$(anthropic_text "$body")"
+
+begin_test 'fields: error, tokens and text from one body'
+body='{"error":{"type":"overloaded_error","message":"Overloaded"}}'
+_llm_fields "$ANTHROPIC_FIELDS" "$body"
+assert_equal 'Overloaded' "$errmsg" 'error message' || true
+body='{"content":[{"text":"[]"}],"usage":{"input_tokens":12,"output_tokens":3,"cache_read_input_tokens":900}}'
+_llm_fields "$ANTHROPIC_FIELDS" "$body"
+assert_equal 'in=12 out=3 cache_creation=0 cache_read=900' "$tkn" 'token sentinel' || true
+assert_equal '[]' "$text" 'text' || true
+if _llm_fields "$ANTHROPIC_FIELDS" '<html>502 Bad Gateway</html>'; then
+  printf '  %s✗%s expected failure on a non-JSON body\n' "$RED" "$NC"
+  TESTS_FAILED+=1
+else
+  printf '  %s✓%s non-JSON body rejected\n' "$GREEN" "$NC"
+  TESTS_PASSED+=1
+fi
+
+begin_test 'render: stream, http, chunks and scope meta in the same pass'
+arr='[{"line":3,"level":"error","bcsCode":"BCS0101"},{"line":30,"level":"warning","bcsCode":"BCS0202"}]'
+out=$(_render_json_output "$arr" /tmp/x.sh ollama m low 0 1 '' '' \
+        $'3\tBCS0103\tcore\terror\tm' 'ttft_ms=5 ttlt_ms=9' $'retry 429\nhedge\n' \
+        $'1 20 7 0\n21 40 8 0' HEAD $'1 10')
+assert_equal '5 9' "$(jq -r '.meta.stream | "\(.ttft_ms) \(.ttlt_ms)"' <<< "$out")" 'meta.stream' || true
+assert_equal '["429"] 1 0' "$(jq -c '.meta.http | [.retries, .hedged, .hedge_wins]' <<< "$out" | jq -r '"\(.[0] | tojson) \(.[1]) \(.[2])"')" 'meta.http' || true
+assert_equal '2' "$(jq '.meta.chunks | length' <<< "$out")" 'meta.chunks' || true
+assert_equal 'HEAD' "$(jq -r '.meta.scope.since' <<< "$out")" 'meta.scope' || true
+assert_equal 'BCS0103 BCS0101' "$(jq -r '[.comments[].bcsCode] | join(" ")' <<< "$out")" \
+  'static first, out-of-scope finding dropped' || true
 
 print_summary 'json-output'
 #fin
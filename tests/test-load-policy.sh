@@ -27,10 +27,10 @@ declare -- PRJ_CONF="$FIXTURE_ROOT"/project/policy.conf
 
 mkdir -p "${SYS_CONF%/*}" "${USR_CONF%/*}" "${PRJ_CONF%/*}"
 
-# Override the cascade helper to emit our fixture paths instead of
+# Override the cascade helper to set our fixture paths instead of
 # /etc/..., $XDG_CONFIG_HOME/... etc.
 _policy_search_paths() {
-  printf '%s\n' "$SYS_CONF" "$USR_CONF" "$PRJ_CONF"
+  POLICY_PATHS=("$SYS_CONF" "$USR_CONF" "$PRJ_CONF")
 }
 
 # Reset policy state so _load_policy re-reads each time.
@@ -0,0 +1,115 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-mock-backend.sh - Offline replay backend (bcs check -m mock:DIR)
+#
+# Runs the full check pipeline against recorded responses: lookup order,
+# injected latency, streaming, chunked scripts, and BCS_MOCK_RECORD capturing
+# a live (stand-in) Anthropic response for later replay.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: mock backend'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+mkdir -p "$work"/mock
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+
+run_check() { isolated_check "$work" --no-cache "$@"; }
+
+begin_test 'replay key is the sha256 of the script, or of the listing'
+key=$(bash -c 'source "$1"; _mock_key "" "$2"' _ "$BCS_CMD" "$work"/s.sh)
+assert_equal "$(sha256sum < "$work"/s.sh | cut -d' ' -f1)" "$key" 'script hash' || true
+assert_equal "$(printf '   1: x\n' | sha256sum | cut -d' ' -f1)" \
+  "$(bash -c 'source "$1"; _mock_key "   1: x" "$2"' _ "$BCS_CMD" "$work"/s.sh)" 'listing hash' || true
+
+begin_test 'json: hash-keyed response replayed through the full pipeline'
+printf '%s\n' '[{"line":2,"level":"warning","bcsCode":"BCS0702","tier":"style","message":"m"}]' \
+  '___TOKENS___ in=120 out=30' > "$work"/mock/"$key".json
+declare -i rc=0
+out=$(run_check -j -q -m mock:"$work"/mock "$work"/s.sh 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0 on a warning' || true
+assert_equal mock "$(jq -r '.meta.backend' <<< "$out")" 'meta.backend' || true
+assert_equal BCS0702:2 "$(jq -r '.comments[] | "\(.bcsCode):\(.line)"' <<< "$out")" 'finding' || true
+assert_equal 30 "$(jq -r '.meta.tokens.out' <<< "$out")" 'recorded tokens reported' || true
+
+begin_test 'text: script-name then default fallbacks'
+printf '[ERROR] BCS0101 line 1: named\n' > "$work"/mock/s.sh.txt
+printf '[WARN] BCS0702 line 2: default\n' > "$work"/mock/default.txt
+rc=0
+out=$(run_check -m mock:"$work"/mock "$work"/s.sh 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'exit 1 on [ERROR]' || true
+assert_contains "$out" 'named' 'DIR/<name>.txt' || true
+cp "$work"/s.sh "$work"/other.sh
+out=$(BCS_MOCK_DIR="$work"/mock run_check -m mock "$work"/other.sh 2>/dev/null) || true
+assert_contains "$out" 'default' 'DIR/default.txt via BCS_MOCK_DIR' || true
+
+begin_test 'cached replays follow the mock responses'
+cached() { isolated_check "$work" -m mock "$@"; }
+mkdir -p "$work"/mock2
+printf '[WARN] BCS0702 line 2: first\n' > "$work"/mock2/default.txt
+BCS_MOCK_DIR="$work"/mock2 cached "$work"/other.sh &>/dev/null ||:
+printf '[WARN] BCS0702 line 2: second\n' > "$work"/mock2/default.txt
+out=$(BCS_MOCK_DIR="$work"/mock2 cached "$work"/other.sh 2>/dev/null) ||:
+assert_contains "$out" 'second' 'edited response is a cache miss' || true
+out=$(BCS_MOCK_DIR="$work"/mock cached "$work"/other.sh 2>/dev/null) ||:
+assert_contains "$out" 'default' 'other BCS_MOCK_DIR is a cache miss' || true
+
+begin_test 'missing directory or response fails with exit 3'
+rc=0
+run_check -m mock:"$work"/nowhere "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'no directory' || true
+rm "$work"/mock/default.txt
+rc=0
+run_check -m mock:"$work"/mock "$work"/other.sh &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'no response' || true
+printf '[WARN] BCS0702 line 2: default\n' > "$work"/mock/default.txt
+
+begin_test 'BCS_MOCK_LATENCY delays the response'
+t0=${EPOCHREALTIME/./}
+BCS_MOCK_LATENCY=400 run_check -m mock:"$work"/mock "$work"/other.sh &>/dev/null || true
+assert_gt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 399 'at least 400ms' || true
+
+begin_test '--stream replays incrementally with first-token timing'
+rc=0
+out=$(BCS_MOCK_LATENCY=50 run_check --stream -m mock:"$work"/mock "$work"/other.sh 2>"$work"/err) || rc=$?
+assert_equal '[WARN] BCS0702 line 2: default' "$out" 'printed once' || true
+assert_matches "$(< "$work"/err)" 'Stream: first token [0-9]+ms' 'timing diagnostic' || true
+
+begin_test 'chunked scripts fall back per chunk'
+{ echo '#!/bin/bash'; for i in 1 2 3; do printf 'f%d() {\n' "$i"; printf '  :\n%.0s' {1..8}; echo '}'; done; } \
+  > "$work"/long.sh
+printf '[]\n' > "$work"/mock/default.json
+out=$(run_check -j -q --chunk-lines 12 -m mock:"$work"/mock "$work"/long.sh 2>/dev/null) || true
+assert_gt "$(jq '.meta.chunks | length' <<< "$out")" 1 'several chunks' || true
+assert_equal 0 "$(jq '.comments | length' <<< "$out")" 'empty findings merged' || true
+
+# ---------------------------------------------------------------------
+# Recording from a vendor-shaped stand-in
+# ---------------------------------------------------------------------
+if ! start_http_standin "$work"; then
+  echo '  (skipping record tests - python3 not available)'
+  print_summary 'mock-backend'
+  exit
+fi
+
+jq -n '{content: [{type: "text", text: "[ERROR] BCS0101 line 1: recorded"}],
+        usage: {input_tokens: 7, output_tokens: 3}}' > "$work"/response.json
+echo 0.3 > "$work"/delay
+
+begin_test 'BCS_MOCK_RECORD saves the live response for replay'
+t0=${EPOCHREALTIME/./}
+live=$(ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+  BCS_MOCK_RECORD="$work"/rec run_check -m claude-haiku-4-5 "$work"/s.sh 2>/dev/null) || true
+assert_gt $(( (${EPOCHREALTIME/./} - t0) / 1000 )) 299 'stand-in delay applied' || true
+assert_equal "$(printf '[ERROR] BCS0101 line 1: recorded\n___TOKENS___ in=7 out=3 cache_creation=0 cache_read=0')" \
+  "$(cat "$work"/rec/"$key".txt)" 'response and tokens saved under the script hash' || true
+replay=$(run_check -m mock:"$work"/rec "$work"/s.sh 2>/dev/null) || true
+assert_equal "$live" "$replay" 'replay matches the live report' || true
+assert_equal 1 "$(ls "$work"/req.*.json | wc -l)" 'replay made no request' || true
+
+print_summary 'mock-backend'
+#fin
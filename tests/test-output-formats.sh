@@ -0,0 +1,134 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-output-formats.sh - bcs check --format: one SARIF 2.1.0 log across
+# every checked file, and NDJSON findings streamed per file, against the
+# mock backend.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: output formats'
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+mkdir -p "$work"/src "$work"/mock "$work"/clean
+printf '#!/bin/bash\necho hi\n' > "$work"/src/a.sh
+printf '#!/bin/bash\necho "a b"\n' > "$work"/src/'b c.sh'
+printf '#!/bin/bash\necho ok\n' > "$work"/ok.sh
+printf '[{"line":2,"endLine":3,"level":"warning","bcsCode":"BCS0702","message":"a"},
+  {"line":1,"level":"error","bcsCode":"BCS0101","tier":"core","message":"b","fixSuggestion":"f"},
+  {"line":2,"level":"info","bcsCode":"BCS0702","message":"c"}]' > "$work"/mock/default.json
+printf '[]' > "$work"/mock/ok.sh.json
+printf '[WARN] BCS0702 line 2: a\n' > "$work"/mock/default.txt
+
+check() { isolated_check "$work" -q --no-cache -m mock:"$work"/mock "$@"; }
+
+# ---------------------------------------------------------------------
+# NDJSON
+# ---------------------------------------------------------------------
+begin_test 'ndjson: one finding per line, each with its file'
+declare -i rc=0
+out=$(check --format ndjson "$work"/src/a.sh 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'exit 1 (an error finding)' || true
+assert_equal 3 "$(wc -l <<< "$out")" 'three lines' || true
+assert_equal "$work/src/a.sh BCS0101" "$(sed -n 2p <<< "$out" | jq -r '"\(.file) \(.bcsCode)"')" \
+  'file and code' || true
+
+begin_test 'ndjson: a clean file prints nothing'
+rc=0
+out=$(check --format=ndjson "$work"/ok.sh 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0' || true
+assert_equal '' "$out" 'no lines' || true
+
+begin_test 'ndjson: a file is printed as soon as it completes'
+# One worker and 600 ms per model call: the first file's findings arrive
+# while the second is still being checked
+span() {
+  local -- line t1
+  IFS= read -r line
+  t1=${EPOCHREALTIME/[.,]/}
+  cat > /dev/null
+  echo $(( (${EPOCHREALTIME/[.,]/} - t1) / 1000 ))
+}
+ms=$(BCS_MOCK_LATENCY=600 check --format ndjson -P 1 "$work"/src/a.sh "$work"/src/'b c.sh' 2>/dev/null | span) ||:
+assert_gt "$ms" 400 'first line well before the end' || true
+ms=$(BCS_MOCK_LATENCY=600 check -j -P 1 "$work"/src/a.sh "$work"/src/'b c.sh' 2>/dev/null | span) ||:
+assert_gt 300 "$ms" 'json waits for the whole run' || true
+
+begin_test 'ndjson: pool output covers every file'
+out=$(check --format ndjson -P 3 "$work"/src/a.sh "$work"/src/'b c.sh' "$work"/ok.sh 2>/dev/null) ||:
+assert_equal 6 "$(wc -l <<< "$out")" 'six findings' || true
+assert_equal 2 "$(jq -r .file <<< "$out" | sort -u | wc -l)" 'two files with findings' || true
+
+# ---------------------------------------------------------------------
+# SARIF
+# ---------------------------------------------------------------------
+begin_test 'sarif: one log across all files'
+rc=0
+out=$(cd "$work" && check --format sarif src/a.sh src/'b c.sh' ok.sh 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'exit 1' || true
+assert_equal '2.1.0 1 6 true' \
+  "$(jq -r '"\(.version) \(.runs | length) \(.runs[0].results | length) \(.runs[0].invocations[0].executionSuccessful)"' <<< "$out")" \
+  'version, single run, results, success' || true
+assert_equal 'bcs BCS0101 BCS0702' "$(jq -r '.runs[0].tool.driver | "\(.name) \([.rules[].id] | join(" "))"' <<< "$out")" \
+  'one rule per code' || true
+assert_equal 'Strict Mode' "$(jq -r '.runs[0].tool.driver.rules[0].shortDescription.text' <<< "$out")" \
+  'rule titled from the index' || true
+assert_equal 'core' "$(jq -r '.runs[0].tool.driver.rules[1].properties.tier' <<< "$out")" \
+  'tier from the rule table when the model gave none' || true
+
+begin_test 'sarif: results carry level, rule and region'
+assert_equal 'warning 1 2 3' \
+  "$(jq -r '.runs[0].results[0] | "\(.level) \(.ruleIndex) \(.locations[0].physicalLocation.region | "\(.startLine) \(.endLine)")"' <<< "$out")" \
+  'warning over lines 2-3' || true
+assert_equal 'error note' "$(jq -r '[.runs[0].results[1,2].level] | join(" ")' <<< "$out")" \
+  'error, and info as note' || true
+assert_equal null "$(jq -c '.runs[0].results[0].locations[0].physicalLocation.region.startColumn' <<< "$out")" \
+  'no empty column span' || true
+
+begin_test 'sarif: URIs relative to the working directory'
+assert_equal 'src/a.sh SRCROOT' \
+  "$(jq -r '.runs[0].results[0].locations[0].physicalLocation.artifactLocation | "\(.uri) \(.uriBaseId)"' <<< "$out")" \
+  'relative with base id' || true
+assert_equal 'src/b%20c.sh' "$(jq -r '.runs[0].results[3].locations[0].physicalLocation.artifactLocation.uri' <<< "$out")" \
+  'percent-encoded' || true
+assert_equal "file://$work/" "$(jq -r '.runs[0].originalUriBaseIds.SRCROOT.uri' <<< "$out")" 'base' || true
+out=$(cd "$work"/clean && check --format sarif "$work"/src/a.sh 2>/dev/null) ||:
+assert_equal "file://$work/src/a.sh null" \
+  "$(jq -r '.runs[0].results[0].locations[0].physicalLocation.artifactLocation | "\(.uri) \(.uriBaseId)"' <<< "$out")" \
+  'absolute outside it' || true
+
+begin_test 'sarif: a clean run is still a valid log'
+out=$(check --format sarif "$work"/ok.sh 2>/dev/null)
+assert_equal '0 0' "$(jq -r '.runs[0] | "\(.results | length) \(.tool.driver.rules | length)"' <<< "$out")" \
+  'no results, no rules' || true
+
+begin_test 'sarif: static engine'
+printf '#!/bin/bash\necho `date`\n' > "$work"/tick.sh
+out=$(isolated_bcs "$work" check -q --engine static --format sarif "$work"/tick.sh 2>/dev/null) ||:
+assert_contains "$(jq -r '[.runs[0].results[].ruleId] | join(" ")' <<< "$out")" 'BCS0101' \
+  'detector findings' || true
+
+# ---------------------------------------------------------------------
+# Selection
+# ---------------------------------------------------------------------
+begin_test 'BCS_FORMAT default; -j and --format override it'
+out=$(BCS_FORMAT=ndjson check "$work"/src/a.sh 2>/dev/null) ||:
+assert_equal 3 "$(wc -l <<< "$out")" 'env selects ndjson' || true
+out=$(BCS_FORMAT=ndjson check -j "$work"/src/a.sh 2>/dev/null) ||:
+assert_equal bcs "$(jq -r .source <<< "$out")" '-j wins' || true
+out=$(BCS_JSON=1 check --format text "$work"/src/a.sh 2>/dev/null) ||:
+assert_contains "$out" '[WARN] BCS0702 line 2' '--format text wins over BCS_JSON' || true
+
+begin_test 'invalid format and --estimate'
+rc=0
+check --format xml "$work"/src/a.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'unknown format -> 22' || true
+rc=0
+check --estimate --format sarif "$work"/src/a.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" '--estimate with sarif -> 22' || true
+
+print_summary 'output-formats'
+#fin
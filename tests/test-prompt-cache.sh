@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-prompt-cache.sh - Anthropic prompt caching: payload shape and
+# cache-token reporting, exercised end-to-end against a local HTTP stand-in
+# (ANTHROPIC_BASE_URL) so the real curl request is what gets asserted.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: Anthropic prompt caching'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+# ---------------------------------------------------------------------
+# Envelope: the token sentinel becomes meta.tokens (no HTTP needed)
+# ---------------------------------------------------------------------
+begin_test 'render: token sentinel becomes meta.tokens'
+out=$(bash -c 'source "$1"; _render_json_output "[]" /x.sh anthropic m medium 0 1 \
+                 "in=12 out=34 cache_creation=0 cache_read=9000"' _ "$BCS_CMD")
+assert_equal '{"in":12,"out":34,"cache_creation":0,"cache_read":9000}' \
+  "$(jq -c '.meta.tokens' <<< "$out")" 'all four counters carried as numbers' || true
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping HTTP stand-in tests - python3 not available)'
+  print_summary 'prompt-cache'
+  exit
+fi
+
+# First call writes the prefix cache, the second reads it.
+usage_json() {
+  printf '{"content":[{"type":"text","text":"[]"}],"usage":{"input_tokens":40,"output_tokens":5,"cache_creation_input_tokens":%d,"cache_read_input_tokens":%d}}' "$1" "$2"
+}
+usage_json 9000 0 > "$work"/response.1.json
+usage_json 0 9000 > "$work"/response.json
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+    --no-cache -m claude-haiku-4-5 "$@" "$work"/s.sh
+}
+
+declare -i rc=0
+out=$(run_check -q -j 2>/dev/null) || rc=$?
+
+begin_test 'request reaches the Messages endpoint'
+assert_equal 0 "$rc" 'check exits 0 on an empty findings array' || true
+assert_equal 'POST /v1/messages' "$(head -1 "$work"/req.1.head)" 'POST /v1/messages' || true
+assert_contains "$(< "$work"/req.1.head)" 'x-api-key: test-key' 'API key sent as a header' || true
+
+begin_test 'system prompt is a cache_control content block'
+req=$(< "$work"/req.1.json)
+assert_equal 'array' "$(jq -r '.system | type' <<< "$req")" 'system is a block array' || true
+assert_equal 'text ephemeral' \
+  "$(jq -r '.system[0] | "\(.type) \(.cache_control.type)"' <<< "$req")" \
+  'single text block marked ephemeral' || true
+assert_contains "$(jq -r '.system[0].text' <<< "$req")" 'Bash Coding Standard' \
+  'block carries the standard' || true
+assert_equal 'string' "$(jq -r '.messages[0].content | type' <<< "$req")" \
+  'per-script user message stays uncached' || true
+
+begin_test 'JSON meta reports cache creation on the first call'
+assert_equal '9000 0' "$(jq -r '.meta.tokens | "\(.cache_creation) \(.cache_read)"' <<< "$out")" \
+  'cache_creation counted' || true
+
+begin_test 'second call reads the cached prefix'
+out=$(run_check -q -j 2>/dev/null) || true
+assert_equal '0 9000' "$(jq -r '.meta.tokens | "\(.cache_creation) \(.cache_read)"' <<< "$out")" \
+  'cache_read counted' || true
+assert_equal "$(jq -c .system "$work"/req.1.json)" "$(jq -c .system "$work"/req.2.json)" \
+  'system block is byte-identical across calls (cacheable prefix)' || true
+
+begin_test 'text mode Tokens line includes cache counters'
+err=$(run_check 2>&1 >/dev/null) || true
+assert_contains "$err" 'Tokens: in=40 out=5 cache_creation=0 cache_read=9000' 'sentinel surfaced' || true
+
+print_summary 'prompt-cache'
+#fin
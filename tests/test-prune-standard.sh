@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-prune-standard.sh - Tier/policy-pruned system prompt for bcs check
+#
+# Unit-tests _excluded_codes/_prune_standard against the real standard, then
+# runs `bcs check -j -D` with a stub Claude CLI to verify the pruned document
+# is what the backend receives and that the size report reaches meta/--debug.
+
+set -euo pipefail
+shopt -s inherit_errexit
+
+#shellcheck source=tests/test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+#shellcheck source=bcs
+source "$BCS_CMD"   # source guard keeps main() from running
+
+echo 'Testing: pruned standard'
+
+declare -- WORK
+WORK=$(mktemp -d) || { echo 'mktemp failed' >&2; exit 1; }
+trap 'rm -rf "$WORK"' EXIT
+
+# A sourced bcs resolves its data dir relative to tests/; point it at the
+# repo's data/ and the policy cascade at a scratch file.
+_find_data_dir() { echo "$DATA_DIR"; }
+_policy_search_paths() { POLICY_PATHS=("$WORK"/policy.conf); }
+reset_policy() { _POLICY_LOADED=0; BCS_POLICY=(); }
+
+declare -- STD="$DATA_DIR"/BASH-CODING-STANDARD.md
+
+# --- _excluded_codes ----------------------------------------------------
+
+begin_test 'no filter, no policy: nothing excluded'
+: > "$WORK"/policy.conf
+reset_policy
+assert_equal '' "$(_excluded_codes core recommended style)" || true
+
+begin_test 'policy-disabled rules are always excluded'
+printf 'BCS0101 = disabled\nBCS0102 = style\n' > "$WORK"/policy.conf
+reset_policy
+excluded=$(_excluded_codes core recommended style)
+assert_equal BCS0101 "$excluded" 'only the disabled rule' || true
+
+begin_test 'core-only filter keeps policy-promoted rules'
+excluded=$(_excluded_codes core)
+assert_contains "$excluded" BCS0102 'BCS0102 demoted to style -> excluded' || true
+assert_not_contains "$excluded" BCS0100 'section overviews never excluded' || true
+printf 'BCS0103 = core\n' > "$WORK"/policy.conf
+reset_policy
+assert_not_contains "$(_excluded_codes core)" BCS0103 'BCS0103 promoted to core -> kept' || true
+
+# --- _prune_standard ----------------------------------------------------
+
+begin_test 'prune drops whole rule blocks only'
+pruned=$(_prune_standard "$STD" BCS0101 BCS0102)
+assert_not_contains "$pruned" '## BCS0101 ' 'BCS0101 heading gone' || true
+assert_not_contains "$pruned" '## BCS0102 ' 'BCS0102 heading gone' || true
+assert_contains "$pruned" '## BCS0100 ' 'section overview kept' || true
+assert_contains "$pruned" '## BCS0103 ' 'neighbouring rule kept' || true
+assert_contains "$pruned" '# Section 02' 'next section heading kept' || true
+assert_equal "$(($(grep -c '^## BCS' "$STD") - 2))" "$(grep -c '^## BCS' <<< "$pruned")" \
+  'exactly two rule headings removed' || true
+
+begin_test 'code-fence "# comment" lines do not end a dropped block'
+# BCS0101 examples contain "# correct" lines inside ``` fences; none of the
+# rule's body may leak through once its heading is dropped.
+# Lines unique to BCS0101's block (heading up to BCS0102) must all be gone.
+leaked=$(awk 'NF{n[$0]++} /^## BCS0102 /{f=0} f&&NF{b[$0]=1} /^## BCS0101 /{f=1}
+              END{for (l in b) if (n[l] == 1) print l}' "$STD" \
+           | grep -cxFf - <<< "$pruned" || true)
+assert_equal 0 "$leaked" 'no line of the dropped rule leaks through' || true
+
+# --- End-to-end via bcs check -------------------------------------------
+
+mkdir -p "$WORK"/.local/bin
+# Stub Claude CLI: record the size of the @-referenced standard, return [].
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+std=$(grep -o 'defined in @[^ ]*\.md' <<< "${*: -1}" | head -1)
+wc -c < "${std#defined in @}" > "$HOME"/sent-bytes
+echo '[]'
+STUB
+chmod +x "$WORK"/.local/bin/claude
+printf '#!/bin/bash\necho hi\n' > "$WORK"/s.sh
+: > "$WORK"/policy.conf
+run_check() {
+  isolated_check "$WORK" XDG_CONFIG_HOME="$WORK"/cfg BCS_CONF_DIR="$WORK" \
+    -j -q --no-cache -m claude-code "$@" "$WORK"/s.sh
+}
+
+begin_test 'check -T core sends the pruned standard'
+out=$(run_check -T core 2>/dev/null) || true
+full=$(jq -r '.meta.prompt.full_bytes' <<< "$out")
+sent=$(jq -r '.meta.prompt.sent_bytes' <<< "$out")
+assert_equal "$(stat -c %s "$STD")" "$full" 'meta.prompt.full_bytes is the whole standard' || true
+assert_lt "$sent" "$full" 'sent_bytes below full_bytes' || true
+assert_equal "$sent" "$(< "$WORK"/sent-bytes)" 'backend received the pruned file' || true
+assert_gt "$(jq -r '.meta.prompt.rules_dropped' <<< "$out")" 0 'rules_dropped counted' || true
+
+begin_test 'check without filters sends the full standard'
+out=$(run_check 2>/dev/null) || true
+assert_equal '0' "$(jq -r '.meta.prompt.rules_dropped' <<< "$out")" 'nothing dropped' || true
+assert_equal "$(stat -c %s "$STD")" "$(< "$WORK"/sent-bytes)" 'original file sent' || true
+
+begin_test '--debug reports before/after size'
+err=$(run_check -D -M recommended 2>&1 >/dev/null) || true
+assert_matches "$err" 'Standard: [0-9.]+K -> [0-9.]+K \([1-9][0-9]* rules pruned' 'size line on stderr' || true
+
+print_summary 'prune-standard'
+#fin
@@ -0,0 +1,151 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-serve.sh - Warm daemon (bcs serve) and its thin client (bcs --client)
+#
+# Starts a daemon on a scratch socket, then checks that forwarded commands
+# replay stdout/stderr/exit exactly as a local run would, that the raw
+# line-delimited JSON protocol answers by id, that identical in-flight
+# requests share one run, and that the client falls back to a local run
+# when no daemon is listening.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: bcs serve'
+
+if ! command -v python3 &>/dev/null; then
+  echo '  (skipping - python3 not available)'
+  print_summary 'serve'
+  exit
+fi
+
+work=$(mktemp -d)
+declare -i daemon=0
+trap '((daemon)) && kill "$daemon" 2>/dev/null; rm -rf "$work"' EXIT
+
+export HOME="$work" XDG_STATE_HOME="$work"/state XDG_CACHE_HOME="$work"/cache \
+       BCS_SOCKET="$work"/bcs.sock
+mkdir -p "$work"/mock "$work"/proj
+printf '#!/bin/bash\necho hi\n' > "$work"/proj/s.sh
+printf '[WARN] BCS0702 line 2: mocked\n' > "$work"/mock/default.txt
+
+# One raw protocol exchange: request lines on stdin, N reply lines out
+raw() {
+  python3 -c '
+import socket, sys
+s = socket.socket(socket.AF_UNIX)
+s.connect(sys.argv[1])
+s.sendall(sys.stdin.buffer.read())
+f = s.makefile("rb")
+for _ in range(int(sys.argv[2])):
+    sys.stdout.write(f.readline().decode())' "$BCS_SOCKET" "$1"
+}
+
+begin_test 'status and client without a daemon'
+declare -i rc=0
+"$BCS_CMD" serve --status &>/dev/null || rc=$?
+assert_equal 1 "$rc" 'serve --status fails' || true
+rc=0
+out=$(cd "$work"/proj && "$BCS_CMD" --client check -q --engine=static s.sh 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'client runs locally' || true
+assert_contains "$out" '[ERROR] BCS0101 line 1:' 'local findings' || true
+
+BCS_MOCK_LATENCY=1000 "$BCS_CMD" serve 2> "$work"/serve.log &
+daemon=$!
+for _ in {1..100}; do [[ ! -S $BCS_SOCKET ]] || break; sleep 0.05; done
+
+begin_test 'daemon listens on a private socket'
+assert_equal 'socket 600' "$(stat -c '%F %a' "$BCS_SOCKET")" 'socket, mode 0600' || true
+assert_contains "$("$BCS_CMD" serve --status)" 'serving on' 'serve --status' || true
+rc=0
+"$BCS_CMD" serve &>/dev/null || rc=$?
+assert_equal 1 "$rc" 'a second daemon refuses' || true
+
+begin_test 'client replays stdout, stderr and exit status'
+rc=0
+local_out=$(cd "$work"/proj && "$BCS_CMD" check --engine=static s.sh 2>"$work"/local.err) || rc=$?
+declare -i crc=0
+client_out=$(cd "$work"/proj && "$BCS_CMD" --client check --engine=static s.sh 2>"$work"/client.err) || crc=$?
+assert_equal "$rc:$local_out" "$crc:$client_out" 'same stdout and exit' || true
+assert_contains "$(< "$work"/client.err)" 'Static engine: 1 finding(s)' 'stderr forwarded' || true
+assert_matches "$(< "$work"/serve.log)" '#[0-9]+: check --engine=static s.sh' 'ran in the daemon' || true
+assert_equal "$("$BCS_CMD" codes -E BCS0101)" "$("$BCS_CMD" --client codes -E BCS0101)" \
+  'codes -E through the daemon' || true
+
+begin_test 'raw protocol answers by id'
+out=$(printf '%s\n' '{"id":7,"cmd":"explain","cwd":"/","args":["BCS0102"]}' 'not json' \
+        '{"id":"x","cmd":"nope"}' | raw 3)
+assert_equal '7 0' "$(jq -rs '.[0] | "\(.id) \(.exit)"' <<< "$out")" 'explain' || true
+assert_contains "$(jq -rs '.[0].stdout' <<< "$out")" 'BCS0102 Shebang' 'explain text' || true
+assert_equal 22 "$(jq -s '.[1].exit' <<< "$out")" 'malformed line -> 22' || true
+assert_equal 'x 2' "$(jq -rs '.[2] | "\(.id) \(.exit)"' <<< "$out")" 'unknown command -> 2' || true
+
+begin_test 'identical in-flight requests are coalesced'
+req=$(jq -nc --arg cwd "$work"/proj \
+        '{cmd: "check", cwd: $cwd, args: ["--no-cache", "-m", "mock:'"$work"'/mock", "s.sh"]}')
+declare -a pids=()
+t0=${EPOCHREALTIME/./}
+for i in 1 2 3; do
+  jq -c --argjson i "$i" '.id = $i' <<< "$req" | raw 1 > "$work"/reply.$i &
+  pids+=($!)
+done
+wait "${pids[@]}"
+elapsed=$(( (${EPOCHREALTIME/./} - t0) / 1000 ))
+assert_lt "$elapsed" 2000 'one 1s review, not three in a row' || true
+assert_equal 2 "$(grep -c 'coalesced check' "$work"/serve.log)" 'two joined the first' || true
+assert_equal '1 2 3' "$(jq -rs 'map(.id) | sort | join(" ")' "$work"/reply.*)" 'every id answered' || true
+assert_equal 2 "$(jq -s 'map(select(.coalesced)) | length' "$work"/reply.*)" 'two marked coalesced' || true
+assert_contains "$(jq -rs '.[0].stdout' "$work"/reply.*)" 'mocked' 'shared result' || true
+
+begin_test 'a changed file is not coalesced with the old run'
+raw 1 <<< "$req" > /dev/null &
+pids=($!)
+sleep 0.3
+printf '#!/bin/bash\necho changed\n' > "$work"/proj/s.sh
+raw 1 <<< "$req" > /dev/null
+wait "${pids[@]}"
+assert_equal 2 "$(grep -c 'coalesced check' "$work"/serve.log)" 'no new coalescing' || true
+
+begin_test 'paths with ] and tabs coalesce and release their slot'
+odd=$'odd]\tname.sh'
+cp "$work"/proj/s.sh "$work/proj/$odd"
+req=$(jq -nc --arg cwd "$work"/proj --arg f "$odd" \
+        '{cmd: "check", cwd: $cwd, args: ["--no-cache", "-m", "mock:'"$work"'/mock", $f]}')
+pids=()
+for i in 1 2; do
+  raw 1 <<< "$req" > "$work"/odd.$i &
+  pids+=($!)
+done
+wait "${pids[@]}"
+assert_equal 3 "$(grep -c 'coalesced check' "$work"/serve.log)" 'second request joined the first' || true
+raw 1 <<< "$req" > /dev/null
+assert_equal 3 "$(grep -c 'coalesced check' "$work"/serve.log)" 'finished run no longer joinable' || true
+assert_contains "$(jq -r .stdout "$work"/odd.1)" 'mocked' 'answered' || true
+
+begin_test 'serve --stop shuts the daemon down'
+rc=0
+"$BCS_CMD" serve --stop &>/dev/null || rc=$?
+assert_equal 0 "$rc" 'stop acknowledged' || true
+wait "$daemon" 2>/dev/null || true
+daemon=0
+assert_equal missing "$([[ -e $BCS_SOCKET ]] && echo present || echo missing)" 'socket removed' || true
+assert_contains "$(< "$work"/serve.log)" 'bcs serve stopped' 'clean exit' || true
+
+begin_test 'daemon stops when its listener dies'
+BCS_SOCKET="$work"/second.sock "$BCS_CMD" serve 2> "$work"/second.log &
+daemon=$!
+for _ in {1..100}; do [[ ! -S $work/second.sock ]] || break; sleep 0.05; done
+pkill -P "$daemon" -f 'python3 -' ||:
+for _ in {1..50}; do kill -0 "$daemon" 2>/dev/null || break; sleep 0.1; done
+rc=124   # still running after 5s
+if ! kill "$daemon" 2>/dev/null; then
+  rc=0
+  wait "$daemon" 2>/dev/null || rc=$?
+fi
+daemon=0
+assert_equal 1 "$rc" 'daemon exits 1' || true
+assert_contains "$(< "$work"/second.log)" 'exited; stopping' 'reported' || true
+
+print_summary 'serve'
+#fin
@@ -0,0 +1,159 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-since-scope.sh - Diff-scoped checking (bcs check --since REF)
+#
+# Unit-tests _changed_ranges/_scope_excerpt/_rows_in_ranges against a scratch
+# git repository, then runs `bcs check --since` with a stub Claude CLI to
+# verify the excerpt is what the backend receives and that out-of-range
+# findings are dropped from the JSON report.
+
+set -euo pipefail
+shopt -s inherit_errexit
+
+#shellcheck source=tests/test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+#shellcheck source=bcs
+source "$BCS_CMD"   # source guard keeps main() from running
+
+echo 'Testing: diff-scoped check'
+
+if ! command -v git &>/dev/null; then
+  echo '  (skipping - git not available)'
+  print_summary 'since-scope'
+  exit
+fi
+
+declare -- WORK
+WORK=$(mktemp -d) || { echo 'mktemp failed' >&2; exit 1; }
+trap 'rm -rf "$WORK"' EXIT
+
+declare -- REPO="$WORK"/repo S="$WORK"/repo/s.sh
+mkdir -p "$REPO"
+git -C "$REPO" init -q
+cat > "$S" <<'EOF'
+#!/usr/bin/env bash
+set -euo pipefail
+shopt -s inherit_errexit
+
+declare -r GREETING=hello
+
+greet() {
+  local -- name=$1
+  echo "$GREETING, $name"
+}
+
+shout() {
+  local -- name=$1
+  echo "${GREETING^^}, ${name^^}"
+}
+
+main() {
+  greet "${1:-world}"
+  shout "${1:-world}"
+}
+
+main "$@"
+#fin
+EOF
+git -C "$REPO" add s.sh
+git -C "$REPO" -c user.name=t -c user.email=t@t commit -qm init
+
+# --- _changed_ranges ------------------------------------------------------
+
+begin_test 'unchanged file has no ranges'
+assert_equal '' "$(_changed_ranges HEAD "$S")" 'empty output' || true
+
+begin_test 'edited line becomes a range'
+sed -i 's/echo "\${GREETING^^}, \${name^^}"/printf "%s\\n" "${GREETING^^}"/' "$S"
+assert_equal '14 14' "$(_changed_ranges HEAD "$S")" 'line 14' || true
+
+begin_test 'unknown ref and new file are distinguished'
+declare -i rc=0
+_changed_ranges no-such-ref "$S" >/dev/null || rc=$?
+assert_equal 2 "$rc" 'bad ref -> 2' || true
+printf '#!/bin/bash\n' > "$REPO"/new.sh
+rc=0
+_changed_ranges HEAD "$REPO"/new.sh >/dev/null || rc=$?
+assert_equal 1 "$rc" 'file absent at ref -> 1' || true
+
+# --- _scope_excerpt / _rows_in_ranges -------------------------------------
+
+begin_test 'excerpt keeps top-level code and the enclosing function only'
+excerpt=$(_scope_excerpt "$S" '14 14')
+assert_contains "$excerpt" '   5: declare -r GREETING=hello' 'globals kept with real number' || true
+assert_contains "$excerpt" '  12: shout() {' 'enclosing function kept' || true
+assert_contains "$excerpt" '  22: main "$@"' 'main call kept' || true
+assert_not_contains "$excerpt" 'greet() {' 'untouched function elided' || true
+assert_contains "$excerpt" '    ...' 'elision marker' || true
+
+begin_test 'function keyword definitions are recognised'
+printf 'a=1\nfunction f {\n  :\n}\nfunction g() {\n  :\n}\nmain\n' > "$WORK"/kw.sh
+excerpt=$(_scope_excerpt "$WORK"/kw.sh '6 6')
+assert_not_contains "$excerpt" 'function f' 'parenless function elided' || true
+assert_contains "$excerpt" '   6:   :' 'touched function kept' || true
+
+begin_test 'rows filter to ranges'
+assert_equal $'14\tB' "$(printf '3\tA\n14\tB\n20\tC\n' | _rows_in_ranges '14 14')" \
+  'only the in-range row' || true
+
+# --- End to end -------------------------------------------------------------
+
+mkdir -p "$WORK"/.local/bin
+# Stub Claude CLI: keep the @-referenced script and return one in-range and
+# one out-of-range finding.
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+f=$(grep -o 'Analyze @[^ ]*' <<< "${*: -1}")
+cp "${f#Analyze @}" "$HOME"/sent.sh
+printf '%s\n' "${*: -1}" > "$HOME"/prompt
+echo '[{"line":14,"level":"warning","bcsCode":"BCS0702","tier":"core","message":"in"},
+      {"line":9,"level":"error","bcsCode":"BCS0301","tier":"core","message":"out"}]'
+STUB
+chmod +x "$WORK"/.local/bin/claude
+
+run_check() {
+  isolated_check "$WORK" BCS_CONF_DIR="$WORK" -j -q --no-cache -m claude-code "$@"
+}
+
+begin_test 'check --since sends the excerpt and drops out-of-range findings'
+declare -- out
+rc=0
+out=$(run_check --since HEAD "$S" 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0: the error finding was out of range' || true
+assert_equal 14 "$(jq -r '[.comments[].line] | join(" ")' <<< "$out")" 'only line 14 kept' || true
+assert_equal '[[14,14]]' "$(jq -c '.meta.scope.ranges' <<< "$out")" 'meta.scope.ranges' || true
+assert_lt "$(jq -r '.meta.prompt.sent_lines' <<< "$out")" \
+  "$(jq -r '.meta.prompt.script_lines' <<< "$out")" 'fewer lines sent' || true
+assert_not_contains "$(< "$WORK"/sent.sh)" 'greet() {' 'backend got the excerpt' || true
+assert_contains "$(< "$WORK"/prompt)" "Lines changed since 'HEAD': 14." 'prompt names the lines' || true
+
+begin_test 'text report is filtered to the changed ranges too'
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+printf '%s\n' '[WARN] BCS0702 line 14: in' '  Fix: keep' '' \
+  '[ERROR] BCS0301 line 9: out' '  Fix: drop' '' \
+  '| BCS Code | Tier | Severity | Line(s) | Description |' \
+  '| BCS0702 | core | WARN | 14 | in |' '| BCS0301 | core | ERROR | 9 | out |'
+STUB
+rc=0
+out=$(run_check --format text --since HEAD "$S" 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0: the error finding was out of range' || true
+assert_contains "$out" '[WARN] BCS0702 line 14' 'in-range finding kept' || true
+assert_contains "$out" 'Fix: keep' 'its fix kept' || true
+assert_not_contains "$out" 'BCS0301' 'out-of-range finding and table row dropped' || true
+
+begin_test 'unchanged file is skipped without a backend call'
+rm -f "$WORK"/sent.sh
+git -C "$REPO" checkout -q s.sh
+out=$(run_check --changed-lines "$S" 2>/dev/null) || true
+assert_equal 0 "$(jq -r '.comments | length' <<< "$out")" 'empty envelope' || true
+assert_equal missing "$([[ -e $WORK/sent.sh ]] && echo present || echo missing)" \
+  'no backend call' || true
+
+begin_test 'unknown ref fails with exit 22'
+rc=0
+run_check --since no-such-ref "$S" &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'exit 22' || true
+
+print_summary 'since-scope'
+#fin
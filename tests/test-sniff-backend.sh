@@ -98,6 +98,17 @@ assert_equal openai "$(_sniff_backend o1)"
 begin_test 'o5 -> openai'
 assert_equal openai "$(_sniff_backend o5)"
 
+# --- Offline replay via mock / mock:DIR ---------------------------------
+
+begin_test 'mock bare -> mock'
+assert_equal mock "$(_sniff_backend mock)"
+
+begin_test 'mock:fixtures -> mock'
+assert_equal mock "$(_sniff_backend mock:fixtures)"
+
+begin_test 'mockingbird (no colon) -> ollama'
+assert_equal ollama "$(_sniff_backend mockingbird)"
+
 # --- Ollama fallback for anything unrecognised --------------------------
 
 begin_test 'minimax-m2:cloud -> ollama'
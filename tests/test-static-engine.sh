@@ -0,0 +1,183 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-static-engine.sh - Deterministic rule engine for bcs check
+#
+# Unit-tests _static_findings against the labelled fixtures and synthetic
+# scripts, then runs `bcs check --engine=static` end to end (no backend) and
+# `--engine=hybrid` with a stub Claude CLI to verify prompt injection and
+# finding merge.
+
+set -euo pipefail
+shopt -s inherit_errexit
+
+#shellcheck source=tests/test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+#shellcheck source=bcs
+source "$BCS_CMD"   # source guard keeps main() from running
+
+echo 'Testing: static engine'
+
+declare -- WORK
+WORK=$(mktemp -d) || { echo 'mktemp failed' >&2; exit 1; }
+trap 'rm -rf "$WORK"' EXIT
+
+_find_data_dir() { echo "$DATA_DIR"; }
+_policy_search_paths() { POLICY_PATHS=("$WORK"/policy.conf); }
+: > "$WORK"/policy.conf
+
+declare -- FIX="$PROJECT_DIR"/tests/fixtures
+
+# Codes reported for a file, one per line, sorted and de-duplicated.
+codes_of() { _static_findings "$1" 0 | cut -f2 | sort -u; }
+
+# --- Detector loading -----------------------------------------------------
+
+begin_test 'detectors load from section files'
+_load_tiers
+assert_gt "${#BCS_DETECTORS[@]}" 4 'at least five detectors declared' || true
+assert_contains "$(printf '%s\n' "${BCS_DETECTORS[@]}" | cut -f1-2)" $'BCS0101\trequire' \
+  'BCS0101 is a require detector' || true
+
+begin_test 'detector lines never reach the assembled standard'
+assert_not_contains "$(< "$DATA_DIR"/BASH-CODING-STANDARD.md)" '<!-- bcs-detect' \
+  'generate strips bcs-detect comments' || true
+
+# --- Fixtures ---------------------------------------------------------------
+
+begin_test 'mechanical fixtures are detected'
+declare -- f expect
+for f in 01-missing-strict-mode 04-backtick-substitution 06-single-bracket-test \
+         14-uses-eval 15-unsafe-tempfile; do
+  expect=$(sed -n 's/^# bcs-fixture-expect: //p' "$FIX"/"$f".sh)
+  assert_equal "$expect" "$(codes_of "$FIX"/"$f".sh)" "$f -> $expect" || true
+done
+
+begin_test 'clean fixtures produce no findings'
+for f in "$FIX"/clean/*.sh; do
+  assert_equal '' "$(_static_findings "$f" 0)" "${f##*/} clean" || true
+done
+
+begin_test 'bcs itself is clean under the static engine'
+assert_equal '' "$(_static_findings "$BCS_CMD" 0)" 'no findings in bcs' || true
+
+# --- Matching rules ---------------------------------------------------------
+
+begin_test 'comments, single quotes and heredocs are ignored'
+cat > "$WORK"/quoted.sh <<'EOF'
+#!/usr/bin/env bash
+set -euo pipefail
+# eval "$x" and `date` in a comment
+printf '%s\n' 'eval `x`'
+awk '
+  /x/ { system("eval `y`") }
+' /dev/null
+cat <<HELP
+Run `bcs check` or eval this.
+HELP
+echo done  # trailing `comment`
+EOF
+assert_equal '' "$(_static_findings "$WORK"/quoted.sh 0)" 'no findings' || true
+
+begin_test 'literal strings and guards are not commands'
+cat > "$WORK"/lookalike.sh <<'EOF'
+#!/usr/bin/env bash
+set -euo pipefail
+echo "- [ ] Todo item"
+echo "uses eval" "$x" "uses eval"
+[[ $root == /tmp/* ]] && pattern="/tmp/trace-*"
+a=$(LC_ALL=C eval "$cmd") || [ -n "$a" ]
+tmp="/tmp/run_$$"
+EOF
+assert_equal $'6\tBCS0501\n6\tBCS1004\n7\tBCS1006' \
+  "$(_static_findings "$WORK"/lookalike.sh 0 | cut -f1-2)" 'only real commands flagged' || true
+
+begin_test 'each offending line is reported with its number'
+cat > "$WORK"/multi.sh <<'EOF'
+#!/usr/bin/env bash
+set -euo pipefail
+a=`date`
+if [ -n "$a" ]; then eval "$a"; fi
+EOF
+assert_equal $'3\tBCS0302\n4\tBCS0501\n4\tBCS1004' \
+  "$(_static_findings "$WORK"/multi.sh 0 | cut -f1-2)" 'line/code rows in order' || true
+
+begin_test 'require rules skip libraries and shebang-less files'
+printf '#!/usr/bin/env bash\n[[ ! -v LIB_V ]] || return 0\nfoo() { :; }\n' > "$WORK"/lib.sh
+assert_equal '' "$(codes_of "$WORK"/lib.sh)" 'top-level return marks a library' || true
+printf 'foo() { :; }\n' > "$WORK"/frag.sh
+assert_equal '' "$(codes_of "$WORK"/frag.sh)" 'no shebang, no require findings' || true
+
+begin_test '#bcscheck disable suppresses the next command or block'
+cat > "$WORK"/supp.sh <<'EOF'
+#!/usr/bin/env bash
+#bcscheck disable=BCS0101
+#bcscheck disable=BCS1004
+eval "$1"
+#bcscheck disable=BCS0302
+f() {
+  x=`date`
+}
+y=`date`
+EOF
+assert_equal $'9\tBCS0302' "$(_static_findings "$WORK"/supp.sh 0 | cut -f1-2)" \
+  'only the unsuppressed backtick remains' || true
+
+begin_test 'excluded codes, policy and strict are honoured'
+assert_equal '' "$(_static_findings "$FIX"/14-uses-eval.sh 0 BCS1004)" 'excluded code skipped' || true
+printf 'BCS1004 = recommended\n' > "$WORK"/policy.conf
+_POLICY_LOADED=0; BCS_POLICY=()
+assert_equal warning "$(_static_findings "$FIX"/14-uses-eval.sh 0 | cut -f4)" 'demoted -> warning' || true
+assert_equal error "$(_static_findings "$FIX"/14-uses-eval.sh 1 | cut -f4)" 'strict -> error' || true
+printf 'BCS1004 = disabled\n' > "$WORK"/policy.conf
+_POLICY_LOADED=0; BCS_POLICY=()
+assert_equal '' "$(_static_findings "$FIX"/14-uses-eval.sh 0)" 'disabled -> skipped' || true
+: > "$WORK"/policy.conf
+
+# --- End to end -------------------------------------------------------------
+
+run_check() { isolated_check "$WORK" BCS_CONF_DIR="$WORK" -q "$@"; }
+
+begin_test 'check --engine=static emits the JSON envelope without a backend'
+declare -- out
+declare -i rc=0
+out=$(run_check -j --engine=static "$FIX"/04-backtick-substitution.sh) || rc=$?
+assert_equal 1 "$rc" 'exit 1 on core findings' || true
+assert_equal static "$(jq -r '.meta.backend' <<< "$out")" 'meta.backend=static' || true
+assert_equal '10 12' "$(jq -r '[.comments[].line] | join(" ")' <<< "$out")" 'both lines reported' || true
+assert_equal BCS0302 "$(jq -r '.comments[0].bcsCode' <<< "$out")" 'bcsCode' || true
+
+begin_test 'check --engine static text mode and tier filter'
+rc=0
+out=$(run_check --engine static "$FIX"/01-missing-strict-mode.sh) || rc=$?
+assert_equal 1 "$rc" 'exit 1' || true
+assert_contains "$out" '[ERROR] BCS0101 line 1:' 'text finding' || true
+rc=0
+out=$(run_check --engine=static -T style "$FIX"/01-missing-strict-mode.sh) || rc=$?
+assert_equal '0:' "$rc:$out" 'core rule filtered out by -T style' || true
+
+begin_test 'invalid engine is rejected'
+rc=0
+run_check --engine=fast "$FIX"/01-missing-strict-mode.sh &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'exit 22' || true
+
+mkdir -p "$WORK"/.local/bin
+# Stub Claude CLI: record the prompt, echo one duplicate and one new finding.
+cat > "$WORK"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+printf '%s\n' "${*: -1}" > "$HOME"/prompt
+echo '[{"line":10,"level":"error","bcsCode":"BCS0302","tier":"core","message":"dup"},
+      {"line":8,"level":"warning","bcsCode":"BCS0103","tier":"recommended","message":"llm"}]'
+STUB
+chmod +x "$WORK"/.local/bin/claude
+
+begin_test 'hybrid injects static findings and merges without duplicates'
+out=$(run_check -j --no-cache -m claude-code --engine=hybrid \
+        "$FIX"/04-backtick-substitution.sh 2>/dev/null) || true
+assert_contains "$(< "$WORK"/prompt)" 'Deterministic findings' 'static block in prompt' || true
+assert_contains "$(< "$WORK"/prompt)" 'BCS0302 line 10' 'finding listed in prompt' || true
+assert_equal 'BCS0302:10 BCS0302:12 BCS0103:8' \
+  "$(jq -r '[.comments[] | "\(.bcsCode):\(.line)"] | join(" ")' <<< "$out")" \
+  'static first, model duplicate dropped' || true
+
+print_summary 'static-engine'
+#fin
@@ -0,0 +1,121 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-stats.sh - The run history written by bcs check (one NDJSON record
+# per checked file) and its summary, bcs stats.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: stats'
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+mkdir -p "$work"/mock
+printf '[WARN] BCS0702 line 2: a\n[ERROR] BCS0101 line 1: b\n' > "$work"/mock/default.txt
+printf '[{"line":2,"level":"warning","bcsCode":"BCS0702","message":"a"}]' > "$work"/mock/default.json
+log="$work"/state/bcs/runs.ndjson
+
+run_bcs() { isolated_bcs "$work" "$@"; }
+check() { isolated_check "$work" -q -m mock:"$work"/mock "$@"; }
+
+# ---------------------------------------------------------------------
+# Recording
+# ---------------------------------------------------------------------
+begin_test 'every check appends one record'
+check "$work"/s.sh &>/dev/null ||:
+check "$work"/s.sh &>/dev/null ||:
+check -j "$work"/s.sh &>/dev/null ||:
+run_bcs check -q --engine static "$work"/s.sh &>/dev/null ||:
+assert_equal 4 "$(wc -l < "$log")" 'four records' || true
+assert_equal 'false true false false' "$(jq -rs 'map(.cache) | join(" ")' "$log")" \
+  'cache hit marked' || true
+assert_equal "$(sha256sum < "$work"/s.sh | cut -d' ' -f1)" "$(jq -rs '.[0].sha256' "$log")" \
+  'script hash' || true
+
+begin_test 'a record carries sizes, phases, findings and exit'
+rec=$(head -1 "$log")
+assert_equal 'mock medium llm 2 20 1 1 1' \
+  "$(jq -r '"\(.backend) \(.effort) \(.engine) \(.lines) \(.bytes) \(.findings.error) \(.findings.warning) \(.exit)"' <<< "$rec")" \
+  'fields' || true
+assert_contains "$(jq -c '.phases | keys' <<< "$rec")" '"backend"' 'backend span without --timings' || true
+assert_equal '0 1' "$(sed -n 3p "$log" | jq -r '"\(.findings.error) \(.findings.warning)"')" \
+  'JSON-mode levels' || true
+assert_equal 'static 1' "$(tail -1 "$log" | jq -r '"\(.backend) \(.findings.error)"')" \
+  'static engine recorded' || true
+
+begin_test 'paths are JSON-escaped'
+cp "$work"/s.sh "$work"/'we"ird\name.sh'
+check "$work"/'we"ird\name.sh' &>/dev/null ||:
+assert_equal "$work/we\"ird\\name.sh" "$(tail -1 "$log" | jq -r .file)" 'round-trips' || true
+
+begin_test 'BCS_HISTORY=0 records nothing'
+BCS_HISTORY=0 check --no-cache "$work"/s.sh &>/dev/null ||:
+assert_equal 5 "$(wc -l < "$log")" 'unchanged' || true
+
+begin_test '--timings output unchanged by recording'
+out=$(check --no-cache -j "$work"/s.sh 2>/dev/null) ||:
+assert_equal null "$(jq -c '.meta.timings' <<< "$out")" 'no meta.timings without --timings' || true
+
+begin_test 'summary table rows are not counted as findings'
+mkdir -p "$work"/table
+printf '%s\n' '[ERROR] BCS0101 line 1: b' '' '| Code | Severity | Line |' \
+  '|------|----------|------|' '| BCS0101 | [ERROR] | 1 |' > "$work"/table/default.txt
+printf '#!/bin/bash\necho a\necho b\necho c\n' > "$work"/four.sh
+isolated_check "$work" XDG_STATE_HOME="$work"/table-state \
+  -q --no-cache -m mock:"$work"/table "$work"/four.sh &>/dev/null ||:
+assert_equal '1 0' "$(jq -r '"\(.findings.error) \(.findings.warning)"' "$work"/table-state/bcs/runs.ndjson)" \
+  'one error' || true
+assert_equal 250 "$(isolated_bcs "$work" XDG_STATE_HOME="$work"/table-state stats -j \
+  | jq -r '.stats.models[0].findings_per_kloc')" 'per KLOC' || true
+
+# ---------------------------------------------------------------------
+# Summary
+# ---------------------------------------------------------------------
+# Ten haiku calls of 1..10 s (p50 5 s, p95 10 s) writing 100 tokens per
+# second, two cache hits, one failure; two old sonnet runs
+{
+  now=$EPOCHSECONDS
+  for i in 1 2 3 4 5 6 7 8 9 10; do
+    printf '{"ts":%d,"file":"/x","backend":"anthropic","model":"claude-haiku-4-5","effort":"low","cache":false,"lines":100,"tokens":{"in":1000,"out":%d},"ms":%d,"llm_ms":%d,"findings":{"error":1,"warning":1},"exit":%d}\n' \
+      "$now" $((i * 100)) $((i * 1000)) $((i * 1000)) $(( i == 10 ? 5 : 0 ))
+  done
+  for i in 1 2; do
+    printf '{"ts":%d,"file":"/x","backend":"anthropic","model":"claude-haiku-4-5","effort":"low","cache":true,"lines":100,"tokens":{"in":0,"out":0},"ms":5,"llm_ms":0,"findings":{"error":1,"warning":1},"exit":0}\n' "$now"
+    printf '{"ts":%d,"file":"/x","backend":"anthropic","model":"claude-sonnet-4-6","effort":"medium","cache":false,"lines":100,"tokens":{"in":1000,"out":100},"ms":20000,"llm_ms":20000,"findings":{"error":0,"warning":0},"exit":0}\n' \
+      $((now - 30 * 86400))
+  done
+  echo '{"torn'
+} > "$log"
+
+begin_test 'stats -j aggregates per model and effort'
+out=$(run_bcs stats -j)
+assert_equal '14 12 2' "$(jq -r '.stats | "\(.runs) \(.calls) \(.cache_hits)"' <<< "$out")" \
+  'totals (torn line skipped)' || true
+haiku=$(jq -c '.stats.models[] | select(.model == "claude-haiku-4-5")' <<< "$out")
+assert_equal '12 10 0.167 5000 10000 100 1000 550 20 1' \
+  "$(jq -r '"\(.runs) \(.calls) \(.cache_hit_rate) \(.latency_ms.p50) \(.latency_ms.p95) \(.output_tokens_per_second) \(.tokens.in) \(.tokens.out) \(.findings_per_kloc) \(.failures)"' <<< "$haiku")" \
+  'haiku row' || true
+assert_equal claude-haiku-4-5 "$(jq -r '.stats.models[0].model' <<< "$out")" 'fastest first' || true
+
+begin_test 'stats filters by age and model'
+assert_equal 12 "$(run_bcs stats -j -d 7 | jq -r .stats.runs)" '--days' || true
+assert_equal 2 "$(run_bcs stats -j -m '*sonnet*' | jq -r .stats.runs)" '--model glob' || true
+
+begin_test 'text table'
+out=$(run_bcs stats)
+assert_contains "$out" 'Runs: 14 (12 calls, 2 cache hits)' 'header' || true
+assert_matches "$out" 'claude-haiku-4-5 +low +12 +17 +5000 +10000 +100' 'haiku line' || true
+
+begin_test 'no history and bad options'
+declare -i rc=0
+HOME="$work"/none XDG_STATE_HOME="$work"/none "$BCS_CMD" stats &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'no history -> 3' || true
+rc=0
+run_bcs stats -d x &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'bad --days -> 22' || true
+
+print_summary 'stats'
+#fin
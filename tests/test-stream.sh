@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-stream.sh - Streaming responses (bcs check --stream): SSE and NDJSON
+# parsing, live text-mode output and first/last-token timing, exercised
+# against a local HTTP stand-in serving canned event streams.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: streaming responses'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+# ---------------------------------------------------------------------
+# Line reader (no HTTP needed)
+# ---------------------------------------------------------------------
+begin_test 'reader passes text through and appends the timing sentinel'
+out=$(bash -c 'source "$1"; printf "a\nb" | _stream_text "$EPOCHREALTIME"' _ "$BCS_CMD")
+assert_equal 'a b' "$(head -2 <<< "$out" | paste -sd' ')" 'text lines kept, last line completed' || true
+assert_matches "$(tail -1 <<< "$out")" '^___STREAM___ ttft_ms=[0-9]+ ttlt_ms=[0-9]+$' 'sentinel' || true
+
+begin_test 'reader copies completed lines to the live descriptor'
+out=$(bash -c 'source "$1"; exec 3>"$2"; printf "\nx\n" | BCS_STREAM_FD=3 _stream_text "$EPOCHREALTIME" >/dev/null
+               cat "$2"' _ "$BCS_CMD" "$work"/live)
+assert_equal $'\nx' "$out" 'leading empty line and text line' || true
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping HTTP stand-in tests - python3 not available)'
+  print_summary 'stream'
+  exit
+fi
+
+printf '#!/bin/bash\necho hi\n' > "$work"/s.sh
+
+# Anthropic SSE: message_start (input usage), text deltas split mid-line,
+# a thinking delta that must not leak, message_delta (output usage).
+sse() { printf 'event: x\ndata: %s\n\n' "$@"; }
+sse '{"type":"message_start","message":{"usage":{"input_tokens":40,"output_tokens":1,"cache_read_input_tokens":900}}}' \
+    '{"type":"content_block_delta","index":0,"delta":{"type":"thinking_delta","thinking":"hmm"}}' \
+    '{"type":"content_block_delta","index":1,"delta":{"type":"text_delta","text":"[ERROR] BCS0101 line 1: no str"}}' \
+    '{"type":"content_block_delta","index":1,"delta":{"type":"text_delta","text":"ict mode\n[WARN] BCS0702 line 2: x"}}' \
+    '{"type":"message_delta","delta":{"stop_reason":"end_turn"},"usage":{"output_tokens":25}}' \
+    '{"type":"message_stop"}' > "$work"/response.json
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+    OLLAMA_HOST="${STANDIN_URL#http://}" --no-cache "$@" "$work"/s.sh
+}
+
+begin_test 'anthropic: --stream requests SSE and prints the report once'
+declare -i rc=0
+out=$(run_check --stream -m claude-haiku-4-5 2>"$work"/err) || rc=$?
+assert_equal 'true' "$(jq -r '.stream' "$work"/req.1.json)" 'payload has stream:true' || true
+assert_equal 1 "$rc" 'exit 1 on [ERROR]' || true
+assert_equal $'[ERROR] BCS0101 line 1: no strict mode\n[WARN] BCS0702 line 2: x' "$out" \
+  'deltas joined across events; thinking dropped; not repeated' || true
+
+begin_test 'anthropic: usage merged and stream timing reported'
+err=$(< "$work"/err)
+assert_contains "$err" 'Tokens: in=40 out=25 cache_creation=0 cache_read=900' 'usage from start+delta' || true
+assert_matches "$err" 'Stream: first token [0-9]+ms, last token [0-9]+ms' 'timing diagnostics' || true
+
+begin_test 'anthropic: --stream --json carries meta.stream'
+sse '{"type":"message_start","message":{"usage":{"input_tokens":4}}}' \
+    '{"type":"content_block_delta","index":0,"delta":{"type":"text_delta","text":"[{\"line\":2,\"level\":\"warning\","}}' \
+    '{"type":"content_block_delta","index":0,"delta":{"type":"text_delta","text":"\"bcsCode\":\"BCS0702\",\"message\":\"m\"}]"}}' \
+    '{"type":"message_delta","usage":{"output_tokens":9}}' > "$work"/response.json
+rc=0
+out=$(run_check --stream -j -q -m claude-haiku-4-5 2>/dev/null) || rc=$?
+assert_equal 0 "$rc" 'exit 0' || true
+assert_equal BCS0702 "$(jq -r '.comments[0].bcsCode' <<< "$out")" 'finding parsed' || true
+assert_equal 'number number' "$(jq -r '.meta.stream | "\(.ttft_ms | type) \(.ttlt_ms | type)"' <<< "$out")" \
+  'meta.stream timings' || true
+assert_equal 9 "$(jq -r '.meta.tokens.out' <<< "$out")" 'meta.tokens.out' || true
+
+begin_test 'anthropic: HTTP error body still surfaces the API message'
+printf '{"type":"error","error":{"type":"overloaded_error","message":"Overloaded"}}' > "$work"/response.json
+printf 529 > "$work"/status
+rc=0
+err=$(run_check --stream -m claude-haiku-4-5 2>&1 >/dev/null) || rc=$?
+rm -f "$work"/status
+assert_equal 5 "$rc" 'exit 5' || true
+assert_contains "$err" 'Overloaded' 'error message' || true
+
+begin_test 'ollama: NDJSON stream'
+printf '%s\n' '{"message":{"content":"[WARN] BCS0702"},"done":false}' \
+  '{"message":{"content":" line 2: y"},"done":false}' \
+  '{"message":{"content":""},"done":true,"prompt_eval_count":7,"eval_count":3}' > "$work"/response.json
+rc=0
+out=$(run_check --stream -m qwen 2>"$work"/err) || rc=$?
+assert_equal 0 "$rc" 'exit 0 on warnings' || true
+assert_equal '[WARN] BCS0702 line 2: y' "$out" 'fragments joined' || true
+assert_contains "$(< "$work"/err)" 'Tokens: in=7 out=3' 'usage from the done line' || true
+assert_equal true "$(jq -r '.stream' "$(ls -t "$work"/req.*.json | head -1)")" 'payload has stream:true' || true
+
+begin_test 'without --stream the payload asks for a single response'
+printf '{"message":{"content":"[WARN] BCS0702 line 2: y"},"prompt_eval_count":1,"eval_count":1}' > "$work"/response.json
+out=$(run_check -q -m qwen 2>/dev/null) || true
+assert_equal false "$(jq -r '.stream' "$(ls -t "$work"/req.*.json | head -1)")" 'stream:false' || true
+assert_equal '[WARN] BCS0702 line 2: y' "$out" 'report printed' || true
+
+print_summary 'stream'
+#fin
@@ -21,14 +21,13 @@ begin_test 'check -h shows help'
 output=$("$BCS_CMD" check -h 2>/dev/null)
 assert_contains "$output" 'bcs check' 'help has command name' || true
 
-# Test: check rejects multiple files
-begin_test 'check rejects multiple files'
+# Test: a missing operand in a multi-file call fails fast (before any check)
+begin_test 'check validates every operand up front'
 temp1=$(mktemp --suffix=.sh)
-temp2=$(mktemp --suffix=.sh)
 echo '#!/bin/bash' > "$temp1"
-echo '#!/bin/bash' > "$temp2"
-assert_fails 'multiple files rejected' "$BCS_CMD" check "$temp1" "$temp2" || true
-rm -f "$temp1" "$temp2"
+err=$("$BCS_CMD" check "$temp1" /nonexistent/file.sh 2>&1 || true)
+assert_contains "$err" 'Script not found' 'second operand validated' || true
+rm -f "$temp1"
 
 # Test: check help includes --model
 begin_test 'check help includes --model'
@@ -135,12 +134,21 @@ assert_not_contains "$err" 'Invalid option' '-se bundling parsed correctly' || t
 begin_test '-- separator works'
 assert_fails '-- then nonexistent' "$BCS_CMD" check -- /nonexistent/file.sh || true
 
-# Test: operands after -- still honour the one-file rule (T-25)
-begin_test 'two operands after -- rejected'
-assert_fails 'check -- a b' "$BCS_CMD" check -- /etc/hostname /etc/hosts || true
+# Test: every operand after -- is collected, none silently dropped (T-25)
+begin_test 'operands after -- are all validated'
+err=$("$BCS_CMD" check /etc/hostname -- /etc/hosts /nonexistent/b.sh 2>&1 || true)
+assert_contains "$err" "Script not found '/nonexistent/b.sh'" 'last operand after -- seen' || true
 
-begin_test 'operand before and after -- rejected'
-assert_fails 'check x -- y' "$BCS_CMD" check /etc/hostname -- /etc/hosts || true
+# Test: -P/--jobs validation
+begin_test '--jobs rejects non-positive values'
+err=$("$BCS_CMD" check -P 0 /etc/hostname 2>&1 || true)
+assert_contains "$err" 'Invalid job count' '-P 0 rejected' || true
+err=$("$BCS_CMD" check --jobs x /etc/hostname 2>&1 || true)
+assert_contains "$err" 'Invalid job count' '--jobs x rejected' || true
+
+begin_test "stdin operand '-' only once"
+err=$("$BCS_CMD" check - - < /dev/null 2>&1 || true)
+assert_contains "$err" "given more than once" "repeated '-' rejected" || true
 
 # Test: BCS_EFFORT from the environment is validated (T-26). test-helpers
 # forces a hermetic BCS_CONF_DIR, so no real bcs.conf masks the env value.
@@ -303,6 +311,103 @@ assert_contains "$out" "resolved from model 'claude-opus-4-8'" \
 
 rm -rf "$sentinel_dir" "$sentinel_home" "$sentinel_script"
 
+# --- multi-file worker pool ---
+# bcs pins PATH to $HOME/.local/bin:..., so a stub `claude` dropped there
+# stands in for the Claude Code CLI. The stub sleeps 1s (2s for *slow*) and
+# reports an [ERROR] for *bad* scripts; the prompt's @file reference carries
+# the script path.
+pool_home=$(mktemp -d)
+mkdir -p "$pool_home"/.local/bin
+cat > "$pool_home"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+prompt=${*: -1}
+[[ $prompt == *slow* ]] && sleep 2 || sleep 1
+[[ $prompt == *bad* ]] && echo '[ERROR] BCS0101 line 1: missing strict mode' || echo 'No findings.'
+STUB
+chmod +x "$pool_home"/.local/bin/claude
+for f in a-slow b-bad c-ok d-ok; do
+  printf '%s\n' '#!/bin/bash' > "$pool_home"/"$f".sh
+done
+run_pool() {
+  HOME="$pool_home" XDG_STATE_HOME="$pool_home"/state BCS_CONF_DIR="$pool_home" \
+    "$BCS_CMD" check -q --no-cache -m claude-code "$@"
+}
+
+begin_test 'multi-file check runs concurrently'
+declare -i pool_rc=0 pool_t0=$SECONDS
+out=$(run_pool -P 4 "$pool_home"/a-slow.sh "$pool_home"/b-bad.sh \
+        "$pool_home"/c-ok.sh "$pool_home"/d-ok.sh 2>/dev/null) || pool_rc=$?
+assert_lt $((SECONDS - pool_t0)) 4 '4 files (5s serial) finish near the slowest' || true
+assert_equal 1 "$pool_rc" 'violation in one file -> aggregate exit 1' || true
+
+begin_test 'multi-file reports are in input order'
+headers=$(grep -o '==> .*/[a-d]-[a-z]*\.sh' <<< "$out" | sed 's|.*/||' | tr '\n' ' ')
+assert_equal 'a-slow.sh b-bad.sh c-ok.sh d-ok.sh ' "$headers" 'slow first file still printed first' || true
+assert_contains "$out" '[ERROR] BCS0101' 'violation report replayed' || true
+
+begin_test "stdin operand '-' reads a NUL-delimited list"
+pool_rc=0
+out=$(printf '%s\0' "$pool_home"/c-ok.sh "$pool_home"/d-ok.sh \
+        | run_pool -P 2 - 2>/dev/null) || pool_rc=$?
+assert_equal 0 "$pool_rc" 'clean files -> exit 0' || true
+assert_contains "$out" 'd-ok.sh <==' 'second listed file checked' || true
+
+begin_test 'single file keeps the plain report (no header)'
+out=$(run_pool "$pool_home"/c-ok.sh 2>/dev/null || true)
+assert_not_contains "$out" '==>' 'no per-file header for one file' || true
+
+# Result cache: the same stub counts its invocations in $HOME/calls.
+cat > "$pool_home"/.local/bin/claude <<'STUB'
+#!/usr/bin/env bash
+echo call >> "$HOME"/calls
+echo 'No findings.'
+STUB
+run_cached() {
+  isolated_bcs "$pool_home" BCS_CONF_DIR="$pool_home" check -q -m claude-code "$@"
+}
+calls() { wc -l < "$pool_home"/calls; }
+
+begin_test 'repeat check is served from the cache'
+run_cached "$pool_home"/c-ok.sh &>/dev/null ||:
+out=$(run_cached "$pool_home"/c-ok.sh 2>/dev/null ||:)
+assert_equal 1 "$(calls)" 'second run makes no backend call' || true
+assert_contains "$out" 'No findings.' 'cached report replayed' || true
+
+begin_test 'changed script misses the cache'
+echo 'echo changed' >> "$pool_home"/c-ok.sh
+run_cached "$pool_home"/c-ok.sh &>/dev/null ||:
+assert_equal 2 "$(calls)" 'edit invalidates the entry' || true
+
+begin_test 'changed settings miss the cache'
+run_cached -e high "$pool_home"/c-ok.sh &>/dev/null ||:
+assert_equal 3 "$(calls)" 'effort is part of the key' || true
+
+begin_test 'changed standard misses the cache'
+printf '# standard\n' > "$pool_home"/std.md
+cache_key() {
+  XDG_CACHE_HOME="$pool_home"/nocache bash -c 'source "$1"; _cache_key "$2" "$3" x' \
+    _ "$BCS_CMD" "$pool_home"/c-ok.sh "$pool_home"/std.md
+}
+key1=$(cache_key)
+echo 'BCS9999 new rule' >> "$pool_home"/std.md
+key2=$(cache_key)
+assert_success 'standard is part of the key' test "${key1%% *}" != "${key2%% *}" || true
+
+begin_test '--no-cache and --refresh bypass cached results'
+run_cached --no-cache "$pool_home"/c-ok.sh &>/dev/null ||:
+run_cached --refresh "$pool_home"/c-ok.sh &>/dev/null ||:
+assert_equal 5 "$(calls)" 'both flags call the backend' || true
+
+begin_test 'bcs cache stats and prune'
+cache_env=(env HOME="$pool_home" XDG_CACHE_HOME="$pool_home"/cache)
+out=$("${cache_env[@]}" "$BCS_CMD" cache stats)
+assert_contains "$out" 'Entries: 3' 'three distinct keys stored' || true
+"${cache_env[@]}" "$BCS_CMD" -q cache prune --max-size 1 &>/dev/null ||:
+out=$("${cache_env[@]}" "$BCS_CMD" cache)
+assert_contains "$out" 'Entries: 0' 'prune to 1 byte evicts all entries' || true
+assert_fails 'bad --max-size' "${cache_env[@]}" "$BCS_CMD" cache prune --max-size 5X || true
+rm -rf "$pool_home"
+
 # Skip actual LLM invocation tests (requires running backend)
 echo '  (skipping live LLM tests - requires running backend)'
 
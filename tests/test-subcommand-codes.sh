@@ -124,5 +124,49 @@ else
   printf '  %s◉%s jq not found — skipping codes --json tests\n' "$CYAN" "$NC"
 fi
 
+# Rule index (data/rules.idx, written by generate), exercised on a copy of
+# the section files so the shipped index is left alone
+idx_dir=$(mktemp -d)
+trap 'rm -rf "$idx_dir"' EXIT
+cp "$DATA_DIR"/[0-9]*.md "$idx_dir"/
+# Run a bcs function with $idx_dir as the data directory; `indexed` prints
+# 1 when the rules came from the index, 0 when they were scanned
+in_idx() {
+  IDX_DIR=$idx_dir bash -c 'source "$1"; shift
+    _find_data_dir() { echo "$IDX_DIR"; }
+    indexed() { _load_tiers; echo "$_RULES_INDEXED"; }
+    "$@"' _ "$BCS_CMD" "$@"
+}
+
+begin_test 'rule index gives the same listing and explanations as a scan'
+scan_list=$(in_idx cmd_codes -J)
+scan_explain=$(in_idx cmd_codes -E BCS0101; in_idx cmd_codes -E BCS0100; in_idx cmd_codes -E BCS1206)
+in_idx _write_rule_index "$idx_dir"
+assert_file_exists "$idx_dir"/rules.idx 'index written' || true
+assert_equal 1 "$(in_idx indexed)" 'index loaded' || true
+assert_equal "$scan_list" "$(in_idx cmd_codes -J)" 'codes -J identical' || true
+assert_equal "$scan_explain" \
+  "$(in_idx cmd_codes -E BCS0101; in_idx cmd_codes -E BCS0100; in_idx cmd_codes -E BCS1206)" \
+  '--explain identical (detector lines stripped)' || true
+declare -i rc=0
+in_idx cmd_codes -E BCS9999 &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'unknown code -> 3' || true
+
+begin_test 'a stale index falls back to the scan'
+touch -d '+1 minute' "$idx_dir"/02-variables.md
+printf '\n## BCS0299 Freshly added rule\n\n**Tier:** style\n' >> "$idx_dir"/02-variables.md
+assert_equal 0 "$(in_idx indexed)" 'newer section file' || true
+assert_contains "$(in_idx cmd_codes)" 'BCS0299 [style] Freshly added rule' 'new rule listed' || true
+in_idx _write_rule_index "$idx_dir"
+cp "$DATA_DIR"/00-index.md "$idx_dir"/00-extra.md
+assert_equal 0 "$(in_idx indexed)" 'added section file' || true
+rm "$idx_dir"/00-extra.md
+
+begin_test 'a moved rule body is found by scanning'
+sed -i 's/^\(R\tBCS0101\t[^\t]*\t[^\t]*\t[0-9]*\t\)[0-9]*/\10/' "$idx_dir"/rules.idx
+assert_equal 1 "$(in_idx indexed)" 'index still current' || true
+assert_equal "$(sed -n 1p <<< "$scan_explain")" "$(in_idx cmd_codes -E BCS0101 | head -1)" \
+  'heading mismatch detected' || true
+
 print_summary 'codes'
 #fin
@@ -84,5 +84,132 @@ assert_fails 'rejects --invalid' "$BCS_CMD" display --invalid || true
 begin_test 'display rejects removed -s option'
 assert_fails 'rejects -s (removed)' "$BCS_CMD" display -s || true
 
+# ---------------------------------------------------------------------
+# Rules and sections: only their byte ranges are read
+# ---------------------------------------------------------------------
+begin_test 'display BCS#### shows one rule'
+output=$("$BCS_CMD" display BCS0603 2>/dev/null)
+assert_equal '## BCS0603 Trap Handling' "$(head -1 <<< "$output")" 'starts at its heading' || true
+assert_equal 1 "$(grep -c '^## BCS' <<< "$output")" 'one rule' || true
+assert_contains "$output" '**Tier:** core' 'with its body' || true
+assert_equal "$output" "$("$BCS_CMD" display bcs0603 2>/dev/null)" 'case-insensitive' || true
+
+begin_test 'display NN shows one section'
+output=$("$BCS_CMD" display 6 2>/dev/null)
+assert_equal '# Section 06: Error Handling' "$(head -1 <<< "$output")" 'section heading' || true
+assert_equal "$(grep -c '^## BCS06' "$DATA_DIR"/BASH-CODING-STANDARD.md)" \
+  "$(grep -c '^## BCS' <<< "$output")" 'every rule of the section' || true
+assert_not_contains "$output" '## BCS07' 'nothing after it' || true
+assert_equal "$output" "$("$BCS_CMD" display BCS0603 06 2>/dev/null)" \
+  'a rule inside a requested section is not repeated' || true
+
+begin_test 'display --grep shows the matching rules'
+output=$("$BCS_CMD" display --grep 'trap .*EXIT' 2>/dev/null)
+assert_contains "$output" '## BCS0603 Trap Handling' 'matching rule' || true
+assert_not_contains "$output" '## BCS0101 ' 'other rules left out' || true
+
+begin_test 'display rule errors'
+declare -i rc=0
+"$BCS_CMD" display BCS9999 &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'unknown rule -> 3' || true
+rc=0
+"$BCS_CMD" display nonsense &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'bad target -> 22' || true
+rc=0
+"$BCS_CMD" display -g 'zzz-no-such-text' &>/dev/null || rc=$?
+assert_equal 1 "$rc" 'no match -> 1' || true
+
+begin_test 'rule index ranges match the document'
+assert_equal "$(grep '^A' "$DATA_DIR"/rules.idx)" \
+  "$(bash -O extglob -c 'source "$1"; _doc_ranges "$2"' _ "$BCS_CMD" "$DATA_DIR"/BASH-CODING-STANDARD.md)" \
+  'A rows equal a fresh scan' || true
+
+# ---------------------------------------------------------------------
+# Rendered-standard cache: a copy of bcs with its own data dir and a
+# stub md2ansi that logs each render, run on a pseudo-terminal with a
+# stub pager that records what it was given
+# ---------------------------------------------------------------------
+if command -v script &>/dev/null; then
+  dc=$(mktemp -d)
+  trap 'rm -rf "$dc"' EXIT
+  mkdir -p "$dc"/data "$dc"/examples "$dc"/.local/bin
+  cp -r "$BCS_CMD" "$PROJECT_DIR"/lib "$dc"/
+  cp "$DATA_DIR"/[0-9]*.md "$DATA_DIR"/BASH-CODING-STANDARD.md "$dc"/data/
+  chmod u+w "$dc"/data/*
+  cat > "$dc"/examples/md2ansi <<STUB
+#!/bin/bash
+echo "\$2 \${TERM:-}" >> "$dc"/renders.log
+printf 'width=%s\n' "\$2"; cat "\$4"
+STUB
+  cat > "$dc"/.local/bin/less <<STUB
+#!/bin/bash
+if [[ \${!#} == -* ]]; then
+  printf 'stdin %s\n' "\$(head -c \${LESS_READ:-999999999} | wc -c)" >> "$dc"/less.log
+else
+  printf 'file %s\n' "\${!#}" >> "$dc"/less.log
+fi
+STUB
+  chmod +x "$dc"/examples/md2ansi "$dc"/.local/bin/less
+  dc_display() {
+    HOME="$dc" XDG_CACHE_HOME="$dc"/cache TERM=xterm-256color COLUMNS=${1:-100} \
+      script -qec "$dc/bcs display" /dev/null >/dev/null
+  }
+  dc_entries() { find "$dc"/cache/bcs/display -name '*.ansi' 2>/dev/null | sort; }
+  dc_renders() { wc -l < "$dc"/renders.log; }
+  : > "$dc"/renders.log
+
+  begin_test 'display renders once and caches the result'
+  dc_display
+  assert_equal 1 "$(dc_renders)" 'one render' || true
+  entry=$(dc_entries)
+  assert_contains "$entry" "/$(sha256sum < "$dc"/data/BASH-CODING-STANDARD.md | cut -d' ' -f1)/100.xterm-256color.ansi" \
+    'keyed by digest, width and TERM' || true
+  assert_contains "$(head -1 "$entry")" 'width=100' 'rendered at the terminal width' || true
+
+  begin_test 'a hit streams the entry to the pager'
+  dc_display
+  assert_equal 1 "$(dc_renders)" 'no render' || true
+  assert_equal "file $entry" "$(tail -1 "$dc"/less.log)" 'pager reads the entry' || true
+
+  begin_test 'another width, or a newer md2ansi, renders again'
+  dc_display 120
+  assert_equal 2 "$(dc_renders)" 'width 120 rendered' || true
+  touch "$dc"/examples/md2ansi
+  dc_display
+  assert_equal 3 "$(dc_renders)" 'stale entry rendered' || true
+
+  begin_test 'early pager quit still completes the entry'
+  rm -rf "$dc"/cache/bcs/display
+  LESS_READ=10 dc_display 90
+  for _ in {1..50}; do [[ -n $(dc_entries) ]] && break; sleep 0.1; done
+  entry=$(dc_entries)
+  assert_contains "$entry" '/90.xterm-256color.ansi' 'entry written in the background' || true
+  assert_equal "$(($(wc -c < "$dc"/data/BASH-CODING-STANDARD.md) + 9))" "$(wc -c < "$entry")" \
+    'entry complete' || true
+
+  begin_test 'generate re-renders a replaced standard in the background'
+  old_dir=${entry%/*}
+  printf '\nA new paragraph.\n' >> "$dc"/data/05-control-flow.md
+  HOME="$dc" XDG_CACHE_HOME="$dc"/cache "$dc"/bcs generate -q 2>/dev/null
+  new_digest=$(sha256sum < "$dc"/data/BASH-CODING-STANDARD.md | cut -d' ' -f1)
+  for _ in {1..50}; do [[ -f $dc/cache/bcs/display/$new_digest/90.xterm-256color.ansi ]] && break; sleep 0.1; done
+  assert_file_exists "$dc/cache/bcs/display/$new_digest/90.xterm-256color.ansi" 'new digest rendered' || true
+  assert_equal gone "$([[ -d $old_dir ]] && echo present || echo gone)" 'old renders dropped' || true
+  renders=$(dc_renders)
+  dc_display 90
+  assert_equal "$renders" "$(dc_renders)" 'next display is a hit' || true
+
+  begin_test 'a stale index falls back to scanning the document'
+  sed -i 's/^H\t.*/H\tstale/' "$dc"/data/rules.idx
+  chmod u+w "$dc"/data/BASH-CODING-STANDARD.md
+  printf '\n## BCS0699 Added Rule\n\nNew.\n' >> "$dc"/data/BASH-CODING-STANDARD.md
+  output=$(HOME="$dc" "$dc"/bcs display BCS0699 2>/dev/null) ||:
+  assert_contains "$output" 'New.' 'found by the scan' || true
+
+  begin_test 'cache stats count renders'
+  out=$(HOME="$dc" XDG_CACHE_HOME="$dc"/cache "$dc"/bcs cache stats 2>/dev/null)
+  assert_contains "$out" 'Renders: 1 (display)' 'counted apart' || true
+fi
+
 print_summary 'display'
 #fin
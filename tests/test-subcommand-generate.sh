@@ -93,5 +93,91 @@ else
 fi
 rm -f "$temp_regen"
 
+# ---------------------------------------------------------------------
+# Incremental generate: a copy of bcs next to its own data dir, so
+# sections can be edited without touching the tree
+# ---------------------------------------------------------------------
+inc=$(mktemp -d)
+trap 'rm -f "$temp_file"; rm -rf "$inc"' EXIT
+mkdir -p "$inc"/data "$inc"/mock
+cp -r "$BCS_CMD" "$PROJECT_DIR"/lib "$inc"/
+cp "$DATA_DIR"/[0-9]*.md "$DATA_DIR"/BASH-CODING-STANDARD.md "$inc"/data/
+chmod u+w "$inc"/data/*
+inc_md="$inc"/data/BASH-CODING-STANDARD.md
+inc_gen() { XDG_CACHE_HOME="$inc"/cache HOME="$inc" "$inc"/bcs generate "$@"; }
+
+begin_test 'first run with a current standard writes nothing'
+touch -d '2020-01-01' "$inc_md"
+out=$(inc_gen -d 2>&1)
+assert_contains "$out" 'is up to date' 'reported up to date' || true
+assert_equal 2020 "$(date -r "$inc_md" +%Y)" 'output not rewritten' || true
+assert_contains "$out" "$(sha256sum < "$inc_md" | cut -d' ' -f1)" '--digest prints the sha256' || true
+
+begin_test 'unchanged sources are a no-op'
+out=$(inc_gen 2>&1)
+assert_contains "$out" '(0 of 15 sections re-read, 0 changed)' 'nothing re-read' || true
+assert_not_contains "$out" 'rule index' 'rule index left alone' || true
+
+begin_test 'a touched section is re-read but not rewritten'
+touch "$inc"/data/05-control-flow.md
+out=$(inc_gen 2>&1)
+assert_contains "$out" '(1 of 15 sections re-read, 0 changed)' 'one re-read, same digest' || true
+assert_equal 2020 "$(date -r "$inc_md" +%Y)" 'output not rewritten' || true
+assert_not_contains "$out" 'rule index' 'rule index not rewritten' || true
+assert_success 'rule index still trusted' \
+  bash -c 'source "$1"; _load_rule_index "$2"' _ "$inc"/bcs "$inc"/data
+assert_contains "$(inc_gen 2>&1)" '(0 of 15 sections re-read' 'manifest restamped' || true
+
+begin_test 'a detector-only edit updates the rule index, not the standard'
+sed -i '0,/<!-- bcs-detect /s//<!-- bcs-detect  /' "$inc"/data/05-control-flow.md
+out=$(inc_gen 2>&1)
+assert_contains "$out" '1 changed)' 'digest changed' || true
+assert_equal 2020 "$(date -r "$inc_md" +%Y)" 'output not rewritten' || true
+assert_contains "$out" 'Updated rule index' 'rule index rewritten' || true
+
+begin_test 'an edited section is spliced in'
+printf '\nSpliced line.\n' >> "$inc"/data/07-io-messaging.md
+out=$(inc_gen 2>&1)
+assert_contains "$out" '(1 rendered)' 'only the edited section rendered' || true
+rm -f "$inc"/full.md
+inc_gen -f -o "$inc"/full.md 2>/dev/null
+if cmp -s "$inc_md" "$inc"/full.md; then
+  printf '  %s✓%s spliced output matches a full rebuild\n' "$GREEN" "$NC"
+  TESTS_PASSED+=1
+else
+  printf '  %s✗%s spliced output differs from a full rebuild\n' "$RED" "$NC"
+  TESTS_FAILED+=1
+fi
+
+begin_test '--check verifies freshness without writing'
+declare -i rc=0
+inc_gen --check &>/dev/null || rc=$?
+assert_equal 0 "$rc" 'fresh -> 0' || true
+printf '\nNot yet generated.\n' >> "$inc"/data/02-variables.md
+before=$(sha256sum < "$inc_md")
+rc=0
+out=$(inc_gen -c 2>&1) || rc=$?
+assert_equal 1 "$rc" 'stale -> 1' || true
+assert_contains "$out" 'changed: 02-variables.md' 'names the stale section' || true
+assert_equal "$before" "$(sha256sum < "$inc_md")" 'output untouched' || true
+rc=0
+XDG_CACHE_HOME="$inc"/nocache "$inc"/bcs generate -c &>/dev/null || rc=$?
+assert_equal 1 "$rc" 'stale without a manifest -> 1' || true
+
+begin_test 'check cache keys follow the standard digest'
+inc_gen -q 2>/dev/null
+printf '#!/bin/bash\necho hi\n' > "$inc"/s.sh
+printf '[WARN] BCS0702 line 2: a\n' > "$inc"/mock/default.txt
+inc_check() {
+  XDG_CACHE_HOME="$inc"/cache XDG_STATE_HOME="$inc"/state HOME="$inc" \
+    "$inc"/bcs check -q --no-shellcheck -m mock:"$inc"/mock "$inc"/s.sh &>/dev/null ||:
+}
+inc_check; inc_check
+printf '\nA new rule text.\n' >> "$inc"/data/03-strings-quoting.md
+inc_gen -q 2>/dev/null
+inc_check
+assert_equal 'false true false' "$(jq -rs 'map(.cache) | join(" ")' "$inc"/state/bcs/runs.ndjson)" \
+  'a regenerated standard misses the cache' || true
+
 print_summary 'generate'
 #fin
@@ -29,8 +29,20 @@ assert_contains "$output" 'codes' 'main help mentions codes' || true
 begin_test 'main help mentions generate'
 assert_contains "$output" 'generate' 'main help mentions generate' || true
 
+begin_test 'main help mentions cache'
+assert_contains "$output" 'cache' 'main help mentions cache' || true
+
+begin_test 'main help mentions scan'
+assert_contains "$output" 'scan' 'main help mentions scan' || true
+
+begin_test 'main help mentions stats'
+assert_contains "$output" 'stats' 'main help mentions stats' || true
+
+begin_test 'main help mentions serve'
+assert_contains "$output" 'serve' 'main help mentions serve' || true
+
 # Test: help for each subcommand
-for cmd in display template check codes generate; do
+for cmd in display template check scan codes generate cache stats serve; do
   begin_test "help $cmd shows usage"
   output=$("$BCS_CMD" help "$cmd" 2>/dev/null)
   assert_contains "$output" "$cmd" "help $cmd mentions command" || true
@@ -61,14 +73,14 @@ output=$("$BCS_CMD" --version 2>/dev/null)
 source_version=$(grep -m1 'VERSION=' "$BCS_CMD" | head -1 | sed "s/.*VERSION=//; s/'//g")
 assert_contains "$output" "$source_version" "version $source_version in output" || true
 
-# Test: help mentions all 6 subcommands
-begin_test 'help lists all 6 subcommands'
+# Test: help lists all 10 subcommands, one per line
+begin_test 'help lists all 10 subcommands'
 output=$("$BCS_CMD" help 2>/dev/null)
 declare -i missing_cmds=0
-for cmd in display template check codes generate help; do
-  [[ "$output" == *"$cmd"* ]] || missing_cmds+=1
+for cmd in display template check scan codes generate cache stats serve help; do
+  [[ "$output" == *$'\n  '"$cmd "* ]] || missing_cmds+=1
 done
-assert_equal 0 "$missing_cmds" 'all 6 subcommands in help' || true
+assert_equal 0 "$missing_cmds" 'all 10 subcommands in help' || true
 
 # Test: unknown command
 begin_test 'unknown command fails'
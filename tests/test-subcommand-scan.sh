@@ -0,0 +1,133 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-subcommand-scan.sh - bcs scan: script discovery in a git tree
+# (shebang, extension, .gitignore, vendored and binary files), largest-first
+# order, the cache-aware check run and the per-rule summary, against the
+# mock backend.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: subcommand scan'
+
+if ! command -v git &>/dev/null; then
+  echo '  (skipping - git not available)'
+  print_summary 'subcommand-scan'
+  exit
+fi
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+repo=$work/repo
+
+mkdir -p "$repo"/{bin,lib,docs,build,vendor/dep} "$work"/mock
+git -C "$repo" init -q
+printf '#!/bin/bash\necho tool\n' > "$repo"/bin/tool
+{ echo '#!/usr/bin/env bash'; seq 1 40 | sed 's/^/echo /'; } > "$repo"/lib/big.sh
+printf 'echo lib\n' > "$repo"/lib/small.bash
+printf '#!/bin/bash\necho "a b"\n' > "$repo"/docs/'with space.sh'
+printf '#!/usr/bin/python3\nprint(1)\n' > "$repo"/bin/py
+printf 'x\0y\n' > "$repo"/docs/blob.sh
+printf '#!/bin/bash\necho gen\n' > "$repo"/build/gen.sh
+printf '#!/bin/bash\necho dep\n' > "$repo"/vendor/dep/dep.sh
+ln -s ../lib/big.sh "$repo"/bin/link.sh
+printf 'build/\n' > "$repo"/.gitignore
+git -C "$repo" add -A
+git -C "$repo" -c user.name=t -c user.email=t@t commit -qm init
+printf '#!/bin/bash\necho new\n' > "$repo"/bin/untracked
+
+printf '[{"line":2,"level":"warning","bcsCode":"BCS0702","message":"a"},
+  {"line":1,"level":"error","bcsCode":"BCS0101","message":"b"}]' > "$work"/mock/default.json
+printf '[{"line":2,"level":"warning","bcsCode":"BCS0702","message":"a"}]' > "$work"/mock/big.sh.json
+printf '[]' > "$work"/mock/tool.json
+
+run_bcs() { (cd "$repo" && isolated_bcs "$work" "$@"); }
+scan() { run_bcs scan -m mock:"$work"/mock --no-shellcheck "$@"; }
+
+# ---------------------------------------------------------------------
+# Discovery
+# ---------------------------------------------------------------------
+begin_test 'shebang or extension; ignored, vendored, binary and links skipped'
+out=$(run_bcs scan -l 2>/dev/null)
+assert_equal "$(printf '%s\n' bin/tool bin/untracked 'docs/with space.sh' lib/big.sh lib/small.bash)" \
+  "$(sed "s|^$repo/||" <<< "$out" | sort)" 'five scripts' || true
+
+begin_test 'largest first'
+assert_equal "$repo/lib/big.sh" "$(head -1 <<< "$out")" 'big.sh leads' || true
+assert_equal "$repo/lib/small.bash" "$(tail -1 <<< "$out")" 'smallest last' || true
+
+begin_test '--exclude, --no-ignore and SCAN_SKIP_DIRS'
+out=$(run_bcs scan -l -x 'docs/*' -x 'bin/*' 2>/dev/null | sed "s|^$repo/||" | sort)
+assert_equal $'lib/big.sh\nlib/small.bash' "$out" 'globs on the relative path' || true
+out=$(run_bcs scan -l --no-ignore 2>/dev/null)
+assert_contains "$out" "$repo/build/gen.sh" 'ignored file listed' || true
+assert_not_contains "$out" 'vendor/' 'vendored still skipped' || true
+mkdir -p "$work"/conf
+echo 'SCAN_SKIP_DIRS=()' > "$work"/conf/bcs.conf
+out=$(BCS_CONF_DIR="$work"/conf run_bcs scan -l 2>/dev/null)
+assert_contains "$out" "$repo/vendor/dep/dep.sh" 'emptied in bcs.conf' || true
+
+begin_test '-z lists NUL-separated; subdirectories and repeated roots'
+assert_equal 5 "$(run_bcs scan -lz 2>/dev/null | tr -cd '\0' | wc -c)" 'five NULs' || true
+out=$(run_bcs scan -l lib lib/ . 2>/dev/null)
+assert_equal 5 "$(wc -l <<< "$out")" 'no duplicates' || true
+
+begin_test 'a tree outside git is walked whole'
+cp -r "$repo"/lib "$work"/plain
+out=$(run_bcs scan -l "$work"/plain 2>/dev/null | sort)
+assert_equal "$(printf '%s\n' "$work"/plain/big.sh "$work"/plain/small.bash)" "$out" 'both found' || true
+
+# ---------------------------------------------------------------------
+# Checking and summary
+# ---------------------------------------------------------------------
+begin_test 'per-rule summary and exit code'
+declare -i rc=0
+out=$(scan 2>"$work"/err) || rc=$?
+assert_equal 1 "$rc" 'exit 1 (error findings)' || true
+assert_contains "$out" 'Scanned 5 scripts' 'totals' || true
+assert_contains "$out" '0 from cache, 5 reviewed; 4 with findings, 1 clean, 0 failed' 'counts' || true
+assert_matches "$out" 'BCS0702 +core +4 +4  STDOUT vs STDERR Separation' 'most frequent rule first' || true
+assert_matches "$out" 'BCS0101 +core +3 +3  Strict Mode' 'second rule' || true
+assert_not_contains "$(< "$work"/err)" 'Exit: 1' 'no per-file chatter' || true
+
+begin_test 'a second scan is answered from the cache'
+out=$(scan -j 2>/dev/null) ||:
+assert_equal '5 5 4 1 0' \
+  "$(jq -r '.scan | "\(.files) \(.cached) \(.with_findings) \(.clean) \(.failed)"' <<< "$out")" \
+  'all cached' || true
+assert_equal "BCS0702 4 0 4" \
+  "$(jq -r '.scan.rules[0] | "\(.code) \(.findings) \(.errors) \(.warnings)"' <<< "$out")" \
+  'rule levels' || true
+assert_equal "$repo/lib/big.sh 1" \
+  "$(jq -r '.scan.by_file[-1] | "\(.file) \(.findings)"' <<< "$out")" 'per-file counts' || true
+
+begin_test 'check options pass through'
+rc=0
+scan -e bogus >/dev/null 2>&1 || rc=$?
+assert_equal 22 "$rc" '-e reaches check' || true
+out=$(run_bcs scan --engine static -j 2>/dev/null) ||:
+assert_equal 0 "$(jq -r .scan.cached <<< "$out")" 'static engine' || true
+
+begin_test 'failures are counted and shown'
+rm "$work"/mock/default.json
+rc=0
+out=$(scan --no-cache 2>"$work"/err) || rc=$?
+assert_equal 3 "$rc" 'exit 3 (no mock response)' || true
+assert_contains "$out" '3 failed' 'counted' || true
+assert_contains "$(< "$work"/err)" 'No mock response' 'reported' || true
+
+begin_test 'bad input'
+rc=0
+run_bcs scan "$work"/missing &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'missing dir -> 3' || true
+mkdir -p "$work"/empty
+rc=0
+run_bcs scan "$work"/empty &>/dev/null || rc=$?
+assert_equal 3 "$rc" 'no scripts -> 3' || true
+rc=0
+run_bcs scan --bogus &>/dev/null || rc=$?
+assert_equal 22 "$rc" 'bad option -> 22' || true
+
+print_summary 'subcommand-scan'
+#fin
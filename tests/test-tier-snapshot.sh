@@ -0,0 +1,133 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-tier-snapshot.sh - Unit tests for the serialised tier cache
+#
+# _load_tiers saves the parsed rule tables as a sourced Bash snapshot under
+# the cache dir; verifies it matches a fresh scan, is sourced on the next
+# load, is discarded when section files change, and that tier and policy
+# loading start no processes.
+
+set -euo pipefail
+shopt -s inherit_errexit
+
+#shellcheck source=tests/test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+#shellcheck source=bcs
+source "$BCS_CMD"   # source guard keeps main() from running
+
+echo 'Testing: tier snapshot'
+
+declare -- WORK
+WORK=$(mktemp -d) || { echo 'mktemp failed' >&2; exit 1; }
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$WORK"/data
+cp "$DATA_DIR"/[0-9]*.md "$WORK"/data/
+export XDG_CACHE_HOME="$WORK"/cache
+_DATA_DIR="$WORK"/data
+_policy_search_paths() { POLICY_PATHS=("$WORK"/policy.conf); }
+printf 'BCS0101 = style\n' > "$WORK"/policy.conf
+
+declare -- SNAP="$XDG_CACHE_HOME/bcs/tiers/${_DATA_DIR//\//%}.sh"
+
+# Forget every loaded table so the next _load_tiers starts over
+reset_tiers() {
+  _TIERS_LOADED=0 _RULES_INDEXED=0
+  BCS_TIERS=() BCS_DETECTORS=() BCS_RULES=() BCS_RULE_AT=()
+}
+# The loaded tables, for comparing one load with another
+tables() {
+  printf '%s\n' "${BCS_TIERS[*]@K}" "${BCS_DETECTORS[@]}" "${BCS_RULES[@]}" "${BCS_RULE_AT[*]@K}"
+}
+# Keep the snapshot (and anything written since) strictly newer than the
+# section files, as it would be outside a test
+age_sources() { touch -d '-1 minute' "$WORK"/data/*.md; }
+
+age_sources
+
+# --- Writing and reading ------------------------------------------------
+
+begin_test 'first load writes a snapshot equal to the scan'
+reset_tiers
+BCS_TIER_CACHE=0 _load_tiers
+scanned=$(tables)
+assert_equal missing "$([[ -f $SNAP ]] && echo present || echo missing)" 'BCS_TIER_CACHE=0 writes none' || true
+reset_tiers
+_load_tiers
+assert_file_exists "$SNAP" 'snapshot written' || true
+assert_equal "$scanned" "$(tables)" 'same tables' || true
+assert_gt "${#BCS_DETECTORS[@]}" 4 'detectors included' || true
+
+begin_test 'next load sources the snapshot'
+sed -i 's/^BCS_TIERS=(/BCS_TIERS=(BCS9999 marker /' "$SNAP"
+reset_tiers
+_load_tiers
+assert_equal marker "${BCS_TIERS[BCS9999]:-}" 'tables came from the snapshot' || true
+assert_equal core "${BCS_TIERS[BCS0102]:-}" 'rest of the tables intact' || true
+
+begin_test 'a newer section file invalidates it'
+touch -d '-45 seconds' "$SNAP"
+printf '\n## BCS0299 Added rule\n\n**Tier:** style\n' >> "$WORK"/data/02-variables.md
+touch -d '-30 seconds' "$WORK"/data/02-variables.md
+reset_tiers
+_load_tiers
+assert_equal style "${BCS_TIERS[BCS0299]:-}" 'section rescanned' || true
+assert_equal '' "${BCS_TIERS[BCS9999]:-}" 'old snapshot ignored' || true
+assert_contains "$(< "$SNAP")" 'BCS0299' 'snapshot rewritten' || true
+
+begin_test 'an added or removed section file invalidates it'
+cp "$WORK"/data/00-index.md "$WORK"/data/00-extra.md
+printf '## BCS0098 Extra rule\n\n**Tier:** core\n' >> "$WORK"/data/00-extra.md
+touch -d '-30 seconds' "$WORK"/data/00-extra.md
+reset_tiers
+_load_tiers
+assert_equal core "${BCS_TIERS[BCS0098]:-}" 'added file scanned' || true
+rm "$WORK"/data/00-extra.md
+reset_tiers
+_load_tiers
+assert_equal '' "${BCS_TIERS[BCS0098]:-}" 'removed file forgotten' || true
+
+begin_test 'a source changed in the same clock tick is never snapshotted'
+touch -d '+1 minute' "$WORK"/data/03-strings-quoting.md
+reset_tiers
+_load_tiers
+assert_equal missing "$([[ -f $SNAP ]] && echo present || echo missing)" 'snapshot dropped' || true
+age_sources
+
+begin_test 'a rule index snapshot keeps the rule rows'
+_write_rule_index "$WORK"/data
+touch -d '-10 seconds' "$WORK"/data/rules.idx
+reset_tiers
+_load_tiers
+assert_equal 1 "$_RULES_INDEXED" 'loaded from the index' || true
+reset_tiers
+_load_tiers
+assert_equal 1 "$_RULES_INDEXED" 'snapshot marks the rows indexed' || true
+assert_equal "$(cmd_codes -E BCS0101 | head -1)" "$(BCS_TIER_CACHE=0 cmd_codes -E BCS0101 | head -1)" \
+  '--explain via snapshot offsets' || true
+
+# --- Forks ----------------------------------------------------------------
+
+begin_test 'loading tiers and policy starts no process'
+if [[ -r /proc/sys/kernel/ns_last_pid ]]; then
+  # Another process on the host may take a PID meanwhile; one clean try of
+  # three is proof enough
+  declare -i before after forks=99 try
+  for try in 1 2 3; do
+    reset_tiers
+    _POLICY_LOADED=0 BCS_POLICY=()
+    read -r before < /proc/sys/kernel/ns_last_pid
+    _load_tiers
+    _load_policy
+    read -r after < /proc/sys/kernel/ns_last_pid
+    forks=after-before
+    ((forks)) || break
+  done
+  assert_equal 0 "$forks" 'no fork' || true
+  assert_equal style "${BCS_POLICY[BCS0101]:-}" 'policy loaded' || true
+else
+  printf '  %s◉%s no /proc/sys/kernel/ns_last_pid — skipping fork count\n' "$CYAN" "$NC"
+fi
+
+print_summary 'tier-snapshot'
+#fin
@@ -0,0 +1,82 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-timings.sh - Per-phase latency spans (bcs check --timings): span
+# aggregation, the stderr table, and meta.timings in the JSON envelope,
+# with the HTTP phases taken from curl against a local stand-in.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: --timings'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+# ---------------------------------------------------------------------
+# Span recording (no HTTP needed)
+# ---------------------------------------------------------------------
+begin_test 'spans are summed per phase in first-seen order'
+out=$(bash -c 'source "$1"; BCS_TIMINGS_FILE=$2
+               _timing b "" 5; _timing a "" 1; _timing b "" 7; _timing c "$EPOCHREALTIME"
+               _timings_summary "$2"' _ "$BCS_CMD" "$work"/t)
+assert_equal $'b 12 2\na 1 1\nc 0 1' "$out" 'phase ms calls' || true
+
+begin_test 'no file, no spans'
+out=$(bash -c 'source "$1"; unset BCS_TIMINGS_FILE; _timing a "" 1; echo done' _ "$BCS_CMD")
+assert_equal done "$out" 'no-op without BCS_TIMINGS_FILE' || true
+
+begin_test 'curl trailer becomes status plus transfer spans'
+: > "$work"/t
+out=$(bash -c 'source "$1"; BCS_TIMINGS_FILE=$2
+               _curl_status "200 0.010500 0.030000 0.250000 0.400000"' _ "$BCS_CMD" "$work"/t)
+assert_equal 200 "$out" 'status printed' || true
+assert_equal $'http_connect 10\nhttp_tls 19\nhttp_ttfb 250\nhttp_total 400' "$(< "$work"/t)" \
+  'connect, tls handshake, ttfb, total' || true
+
+printf '#!/bin/bash\necho `date`\n' > "$work"/s.sh
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="${STANDIN_URL:-}" ANTHROPIC_API_KEY=test-key \
+    --no-cache "$@" "$work"/s.sh
+}
+
+begin_test 'static engine: table on stderr, meta.timings in JSON'
+err=$(run_check -q --timings --engine=static 2>&1 >/dev/null) || true
+assert_contains "$err" 'Timings:' 'table heading' || true
+assert_matches "$err" 'standard +[0-9]+' 'standard row' || true
+assert_matches "$err" 'static +[0-9]+' 'static row' || true
+out=$(run_check -q -j --timings --engine=static 2>/dev/null) || true
+assert_equal 'read_conf standard static total' "$(jq -r '.meta.timings | keys_unsorted | join(" ")' <<< "$out")" \
+  'meta.timings phases' || true
+
+begin_test 'without --timings there is no table and no meta.timings'
+err=$(run_check -q --engine=static 2>&1 >/dev/null) || true
+assert_not_contains "$err" 'Timings:' 'no table' || true
+out=$(run_check -q -j --engine=static 2>/dev/null) || true
+assert_equal null "$(jq -c '.meta.timings' <<< "$out")" 'no meta.timings' || true
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping HTTP stand-in tests - python3 not available)'
+  print_summary 'timings'
+  exit
+fi
+printf '{"content":[{"type":"text","text":"[]"}],"usage":{"input_tokens":1,"output_tokens":1}}' \
+  > "$work"/response.json
+
+begin_test 'API backend: every phase is timed'
+out=$(run_check -q -j --timings -m claude-haiku-4-5 2>"$work"/err) || true
+declare -- phase
+for phase in read_conf standard prompt payload http_connect http_ttfb http_total parse backend render total; do
+  assert_equal number "$(jq -r --arg p "$phase" '.meta.timings[$p] | type' <<< "$out")" "$phase" || true
+done
+assert_contains "$(< "$work"/err)" 'http_ttfb' 'table lists HTTP phases' || true
+
+begin_test 'API backend: --stream records the same phases'
+printf 'data: %s\n\n' '{"type":"content_block_delta","delta":{"text":"[]"}}' > "$work"/response.json
+out=$(run_check -q -j --timings --stream -m claude-haiku-4-5 2>/dev/null) || true
+assert_equal number "$(jq -r '.meta.timings.http_ttfb | type' <<< "$out")" 'http_ttfb' || true
+assert_equal number "$(jq -r '.meta.stream.ttft_ms | type' <<< "$out")" 'stream timing kept' || true
+
+print_summary 'timings'
+#fin
@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-3.0-or-later
+# test-truncation.sh - Answers cut off at max_tokens: each backend's stop
+# reason is detected, the complete findings are kept and the rest is asked
+# for in a continuation request, against the local HTTP stand-in.
+set -euo pipefail
+shopt -s inherit_errexit
+#shellcheck source-path=SCRIPTDIR source=test-helpers.sh
+source "$(dirname "$0")"/test-helpers.sh
+
+echo 'Testing: truncation'
+
+work=$(mktemp -d)
+trap 'stop_http_standin; rm -rf "$work"' EXIT
+
+if ! start_http_standin "$work"; then
+  echo '  (skipping - python3 not available)'
+  print_summary 'truncation'
+  exit
+fi
+
+{ echo '#!/bin/bash'; for i in $(seq 2 20); do echo "echo $i"; done; } > "$work"/s.sh
+
+run_check() {
+  isolated_check "$work" ANTHROPIC_BASE_URL="$STANDIN_URL" ANTHROPIC_API_KEY=test-key \
+    OPENAI_BASE_URL="$STANDIN_URL" OPENAI_API_KEY=test-key \
+    OLLAMA_HOST="${STANDIN_URL#http://}" BCS_RETRY_BASE_MS=20 \
+    --no-cache --chunk-lines 0 "$@"
+}
+reset_standin() { rm -f "$work"/req.* "$work"/response.* "$work"/status*; }
+
+# A finding object as the model writes it
+finding() { printf '{"line":%d,"endLine":%d,"level":"%s","code":101,"bcsCode":"BCS%s","tier":"core","message":"m %d","fixSuggestion":"f"}' "$1" "$1" "$2" "$3" "$1"; }
+
+# Anthropic Messages body with text $1, stop reason $2 and output tokens $3
+anthropic() {
+  jq -nc --arg t "$1" --arg s "$2" --argjson o "$3" \
+    '{content: [{type: "text", text: $t}], stop_reason: $s, usage: {input_tokens: 100, output_tokens: $o}}'
+}
+
+# ---------------------------------------------------------------------
+begin_test 'Anthropic max_tokens: complete findings kept, rest continued'
+reset_standin
+anthropic "[$(finding 2 error 0101),$(finding 5 warning 0702),{\"line\":9,\"lev" max_tokens 4000 \
+  > "$work"/response.1.json
+anthropic "[$(finding 9 warning 0702),$(finding 12 warning 0703)]" end_turn 300 > "$work"/response.2.json
+declare -i rc=0
+out=$(run_check -j -m claude-haiku-4-5 "$work"/s.sh 2>"$work"/err) || rc=$?
+assert_equal 1 "$rc" 'exit 1 (an error finding), not 5' || true
+assert_equal '2 5 9 12' "$(jq -r '[.comments[].line] | join(" ")' <<< "$out")" 'stitched findings' || true
+assert_equal 4300 "$(jq -r '.meta.tokens.out' <<< "$out")" 'tokens summed' || true
+assert_contains "$(jq -r '.messages[0].content' "$work"/req.2.json)" 'only findings on line 5 and later' \
+  'continuation asks from the last kept line' || true
+assert_contains "$(< "$work"/err)" 'cut off at max_tokens after line 5' 'reported' || true
+
+begin_test 'no continuation for a complete answer'
+reset_standin
+anthropic "[$(finding 2 warning 0702)]" end_turn 50 > "$work"/response.1.json
+rc=0
+run_check -j -m claude-haiku-4-5 "$work"/s.sh &>/dev/null || rc=$?
+assert_equal 0 "$rc" 'exit 0' || true
+assert_equal 1 "$(ls "$work"/req.*.json | wc -l)" 'one request' || true
+
+begin_test 'gives up after BCS_CONTINUE rounds with the findings kept'
+reset_standin
+anthropic "[$(finding 2 warning 0702),{\"li" max_tokens 4000 > "$work"/response.1.json
+anthropic "[$(finding 4 warning 0702),{\"li" max_tokens 4000 > "$work"/response.2.json
+rc=0
+out=$(BCS_CONTINUE=1 run_check -j -m claude-haiku-4-5 "$work"/s.sh 2>"$work"/err) || rc=$?
+assert_equal 0 "$rc" 'valid JSON, exit 0' || true
+assert_equal '2 4' "$(jq -r '[.comments[].line] | join(" ")' <<< "$out")" 'both parts kept' || true
+assert_equal 2 "$(ls "$work"/req.*.json | wc -l)" 'one continuation' || true
+assert_contains "$(< "$work"/err)" 'findings from line 4 on may be missing' 'warned' || true
+
+begin_test 'nothing complete: no retry, invalid JSON as before'
+reset_standin
+anthropic '[{"line":2,"lev' max_tokens 4000 > "$work"/response.1.json
+rc=0
+run_check -j -m claude-haiku-4-5 "$work"/s.sh 2>"$work"/err >/dev/null || rc=$?
+assert_equal 5 "$rc" 'exit 5' || true
+assert_equal 1 "$(ls "$work"/req.*.json | wc -l)" 'no continuation' || true
+assert_contains "$(< "$work"/err)" 'before any complete finding' 'warned' || true
+
+# Server-sent events for text $1 and stop reason $2
+anthropic_sse() {
+  printf 'data: %s\n\n' '{"type":"message_start","message":{"usage":{"input_tokens":100,"output_tokens":1}}}'
+  printf 'data: %s\n\n' "$(jq -nc --arg t "$1" '{type: "content_block_delta", delta: {type: "text_delta", text: $t}}')"
+  printf 'data: %s\n\n' "$(jq -nc --arg s "$2" '{type: "message_delta", delta: {stop_reason: $s}, usage: {output_tokens: 4000}}')"
+}
+
+begin_test 'Anthropic stream: stop_reason from message_delta'
+reset_standin
+anthropic_sse $'[WARN] BCS0702 line 3: a\n[WARN] BCS0703 line 7: b\n[ERR' max_tokens > "$work"/response.1.json
+anthropic_sse $'[WARN] BCS0703 line 7: b\n[WARN] BCS0702 line 12: c' end_turn > "$work"/response.2.json
+out=$(run_check --stream -m claude-haiku-4-5 "$work"/s.sh 2>/dev/null) ||:
+assert_equal 2 "$(ls "$work"/req.*.json | wc -l)" 'continued' || true
+assert_contains "$(jq -r '.messages[0].content' "$work"/req.2.json)" 'line 7 and later' \
+  'the cut finding is asked for again' || true
+assert_contains "$out" 'BCS0702 line 12: c' 'continuation shown' || true
+assert_equal 'a b c' "$(grep -oE 'line [0-9]+: [abc]$' <<< "$out" | cut -d' ' -f3 | paste -sd' ')" \
+  'live text not repeated by the continuation' || true
+
+# ---------------------------------------------------------------------
+begin_test 'OpenAI finish_reason length, text mode'
+reset_standin
+jq -nc '{choices: [{message: {content: "[WARN] BCS0702 line 3: a\nfix a\n[ERROR] BCS0101 line 6: b\nfix b\n[WARN] BCS0703 line 8: par"},
+         finish_reason: "length"}], usage: {prompt_tokens: 100, completion_tokens: 4000}}' > "$work"/response.1.json
+jq -nc '{choices: [{message: {content: "[ERROR] BCS0101 line 6: b\nfix b\n[WARN] BCS0703 line 8: c\nfix c"},
+         finish_reason: "stop"}], usage: {prompt_tokens: 100, completion_tokens: 50}}' > "$work"/response.2.json
+rc=0
+out=$(run_check -m gpt-4.1-mini "$work"/s.sh 2>/dev/null) || rc=$?
+assert_equal 1 "$rc" 'exit 1' || true
+assert_equal 1 "$(grep -c 'BCS0101 line 6' <<< "$out")" 'repeated finding once' || true
+assert_contains "$out" '[WARN] BCS0703 line 8: c' 'cut finding replaced' || true
+assert_not_contains "$out" 'par' 'partial line dropped' || true
+assert_contains "$(jq -r '.messages[1].content' "$work"/req.2.json)" 'line 8 and later' 'resumes at line 8' || true
+
+begin_test 'text answer cut in the summary table is not continued'
+reset_standin
+jq -nc '{choices: [{message: {content: "[WARN] BCS0702 line 3: a\n\n| BCS Code | Tier | Severity | Line(s) | Description |\n| BCS07"},
+         finish_reason: "length"}], usage: {prompt_tokens: 100, completion_tokens: 4000}}' > "$work"/response.1.json
+out=$(run_check -m gpt-4.1-mini "$work"/s.sh 2>/dev/null) ||:
+assert_equal 1 "$(ls "$work"/req.*.json | wc -l)" 'one request' || true
+assert_contains "$out" '[WARN] BCS0702 line 3: a' 'findings kept' || true
+
+# ---------------------------------------------------------------------
+begin_test 'Ollama done_reason length'
+reset_standin
+jq -nc --arg t "{\"findings\": [$(finding 4 warning 0702),{\"line\"" \
+  '{message: {content: $t}, done: true, done_reason: "length", prompt_eval_count: 10, eval_count: 4000}' \
+  > "$work"/response.1.json
+jq -nc --arg t "{\"findings\": [$(finding 15 warning 0703)]}" \
+  '{message: {content: $t}, done: true, done_reason: "stop", prompt_eval_count: 10, eval_count: 40}' \
+  > "$work"/response.2.json
+out=$(run_check -j -m ollama:qwen3 "$work"/s.sh 2>/dev/null) ||:
+assert_equal '4 15' "$(jq -r '[.comments[].line] | join(" ")' <<< "$out")" 'wrapped arrays stitched' || true
+
+print_summary 'truncation'
+#fin